@@ -1,6 +1,8 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
 
@@ -20,16 +22,6 @@ vector<float> getPositions();
 
 vector<unsigned int> getIndices();
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback([[maybe_unused]] GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -43,7 +35,7 @@ void processInput(GLFWwindow *window) {
 void initializeBuffer(unsigned int &vertexArrayBuffer, vector<float> positions) {
     glGenBuffers(1, &vertexArrayBuffer);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffer);
     glBufferData(GL_ARRAY_BUFFER, positions.size() * 2 * sizeof(float), &positions.front(), GL_DYNAMIC_DRAW);
 
     glEnableVertexAttribArray(0);
@@ -90,7 +82,7 @@ void processMovements(GLFWwindow *window, vector<float> &positions) {
 
 void initializeIndexBuffer(unsigned int &indexBuffer, vector<unsigned int> indices) {
     glGenBuffers(1, &indexBuffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices.front(), GL_DYNAMIC_DRAW);
 }
 
@@ -100,24 +92,21 @@ void setBackGround() {
 }
 
 void displayTriangles(const unsigned int &vertexArrayBuffer) {
-    glBindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffer);
-    glDrawElements(GL_TRIANGLES, 27, GL_UNSIGNED_INT, nullptr);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexArrayBuffer);
+    GlState::drawElements(GL_TRIANGLES, 27, GL_UNSIGNED_INT, nullptr);
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, getWidth(), getHeight(), getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(getWidth(), getHeight(), getTitle());
-    glfwMakeContextCurrent(window);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
     unsigned int buffer;
     vector<float> positions = getPositions();
     initializeBuffer(buffer, positions);
@@ -129,16 +118,18 @@ int main() {
     const string fragmentShaderPath = getFragmentShaderSourceFilepath();
 
     unsigned int shader = ShaderUtils::CreateShaderFromFiles(vertexShaderPath, fragmentShaderPath);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
     int colorLocation = glGetUniformLocation(shader, "u_Color");
     if (colorLocation == -1) {
         return -1;
     }
 
-    while (!glfwWindowShouldClose(window)) {
-        processInput(window);
-        processMovements(window, positions);
+    while (!context.shouldClose()) {
+        if (window) {
+            processInput(window);
+            processMovements(window, positions);
+        }
 
         setBackGround();
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -149,14 +140,11 @@ int main() {
         glLineWidth(3.0f);
         glUniform4f(colorLocation, 0.0f, 0.0f, 0.0f, 1.0f);
         displayTriangles(buffer);
-        glfwSwapBuffers(window);
-
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
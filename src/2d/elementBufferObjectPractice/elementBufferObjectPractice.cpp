@@ -2,7 +2,9 @@
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
 
@@ -45,16 +47,6 @@ void main(){
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -73,15 +65,15 @@ unsigned int generateTriangleVertexArray() {
     glGenVertexArrays(1, &triangleVertexArray);
     glGenBuffers(1, &triangleVertexBuffer);
 
-    glBindVertexArray(triangleVertexArray);
-    glBindBuffer(GL_ARRAY_BUFFER, triangleVertexBuffer);
+    GlState::bindVertexArray(triangleVertexArray);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, triangleVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
 
     return triangleVertexArray;
 }
@@ -97,20 +89,20 @@ unsigned int generateSquareVertexArray() {
     glGenBuffers(1, &squareVertexBuffer);
     glGenBuffers(1, &squareElementBuffer);
 
-    glBindVertexArray(squareVertexArray);
+    GlState::bindVertexArray(squareVertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, squareVertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, squareVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 12 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, squareElementBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, squareElementBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(unsigned int), &indices.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     return squareVertexArray;
 }
@@ -124,16 +116,16 @@ unsigned int generateLeftTopTriangle() {
     glGenVertexArrays(1, &leftTopTriangleVertexArray);
     glGenBuffers(1, &leftTopTriangleVertexBuffer);
 
-    glBindVertexArray(leftTopTriangleVertexArray);
+    GlState::bindVertexArray(leftTopTriangleVertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, leftTopTriangleVertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, leftTopTriangleVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
 
     return leftTopTriangleVertexArray;
 }
@@ -150,35 +142,33 @@ unsigned int generateParallelogramVertexArray() {
     glGenBuffers(1, &vertexBuffer);
     glGenBuffers(1, &elementBuffer);
 
-    glBindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 8 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(unsigned int), &indices.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
     unsigned int triangleVertexArray = generateTriangleVertexArray();
@@ -187,33 +177,32 @@ int main() {
     unsigned int parallelogramVertexArray = generateParallelogramVertexArray();
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
         glClearColor(1.0f, 0.647f, 0.0f, 1.0f);
-        processInput(window);
-
-        glBindVertexArray(triangleVertexArray);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        if (window) {
+            processInput(window);
+        }
 
-        glBindVertexArray(squareVertexArray);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        GlState::bindVertexArray(triangleVertexArray);
+        GlState::drawArrays(GL_TRIANGLES, 0, 3);
 
-        glBindVertexArray(leftTopTriangleVertexArray);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        GlState::bindVertexArray(squareVertexArray);
+        GlState::drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
-        glBindVertexArray(parallelogramVertexArray);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        GlState::bindVertexArray(leftTopTriangleVertexArray);
+        GlState::drawArrays(GL_TRIANGLES, 0, 3);
 
-        glfwSwapBuffers(window);
+        GlState::bindVertexArray(parallelogramVertexArray);
+        GlState::drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
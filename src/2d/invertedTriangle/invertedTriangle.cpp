@@ -1,6 +1,8 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
 
@@ -33,16 +35,6 @@ void main() {
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -61,52 +53,49 @@ unsigned int generateTriangleVertexArray() {
     glGenVertexArrays(1, &triangleVertexArray);
     glGenBuffers(1, &triangleVertexBuffer);
 
-    glBindVertexArray(triangleVertexArray);
-    glBindBuffer(GL_ARRAY_BUFFER, triangleVertexBuffer);
+    GlState::bindVertexArray(triangleVertexArray);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, triangleVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
 
     return triangleVertexArray;
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
     unsigned int triangleVertexArray = generateTriangleVertexArray();
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
-        processInput(window);
-
-        glBindVertexArray(triangleVertexArray);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        if (window) {
+            processInput(window);
+        }
 
-        glfwSwapBuffers(window);
+        GlState::bindVertexArray(triangleVertexArray);
+        GlState::drawArrays(GL_TRIANGLES, 0, 3);
 
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
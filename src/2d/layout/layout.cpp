@@ -1,6 +1,8 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
 #include <cmath>
@@ -41,16 +43,6 @@ void main() {
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -72,12 +64,12 @@ unsigned int generateSquareVertexArray() {
     glGenBuffers(1, &squareVertexBuffer);
     glGenBuffers(1, &squareElementBuffer);
 
-    glBindVertexArray(squareVertexArray);
+    GlState::bindVertexArray(squareVertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, squareVertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, squareVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 20 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, squareElementBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, squareElementBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(unsigned int), &indices.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), nullptr);
@@ -86,44 +78,42 @@ unsigned int generateSquareVertexArray() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) (2 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     return squareVertexArray;
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
     unsigned int squareVertexArray = generateSquareVertexArray();
     unsigned int shaderProgram = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shaderProgram);
+    GlState::useProgram(shaderProgram);
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
-        processInput(window);
+        if (window) {
+            processInput(window);
+        }
 
-        glBindVertexArray(squareVertexArray);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        GlState::bindVertexArray(squareVertexArray);
+        GlState::drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shaderProgram);
 
-    glfwTerminate();
     return 0;
 }
 
@@ -1,6 +1,10 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
+#include "expressionApi.h"
+#include <iostream>
 #include <vector>
 #include <string>
 #include <cmath>
@@ -35,16 +39,6 @@ void main(){
 
 vector<float> getMetricsPositions();
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -62,22 +56,27 @@ void scaleCoords(vector<float> &data, float xScale, float yScale) {
     }
 }
 
-template<class Function>
-vector<float> generateCoords(float xStart, float xEnd, float step, Function func) {
+vector<float> generateCoords(float xStart, float xEnd, float step, const Expression &func) {
+    vector<float> xs;
+    for (float i = xStart; i <= xEnd;) {
+        xs.push_back(i);
+        i += step;
+    }
+    vector<float> ys(xs.size());
+    func.evaluate(xs.data(), nullptr, ys.data(), xs.size());
+
     vector<float> data;
-    float yAbsMax = abs(func(xStart));
+    data.reserve(xs.size() * 2);
+    float yAbsMax = abs(func.evaluate(xStart));
     float xAbsMax = max(abs(xStart), abs(xEnd));
 
-    for (float i = xStart; i <= xEnd;) {
-        float y = func(i);
-        data.push_back(i);
-        data.push_back(y);
+    for (size_t i = 0; i < xs.size(); i++) {
+        data.push_back(xs[i]);
+        data.push_back(ys[i]);
 
-        if (float yAbs = abs(y); yAbs > yAbsMax) {
+        if (float yAbs = abs(ys[i]); yAbs > yAbsMax) {
             yAbsMax = yAbs;
         }
-
-        i += step;
     }
 
     scaleCoords(data, xAbsMax, yAbsMax);
@@ -94,8 +93,8 @@ unsigned int createMetricVertexArray() {
     glGenVertexArrays(1, &vertexArray);
     glGenBuffers(1, &arrayBuffer);
 
-    glBindVertexArray(vertexArray);
-    glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+    GlState::bindVertexArray(vertexArray);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
 
     unsigned long vertexBufferSize = positions.size() * sizeof(float);
     glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
@@ -103,8 +102,8 @@ unsigned int createMetricVertexArray() {
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
@@ -116,35 +115,45 @@ unsigned int createGraphVertexArray(vector<float> coords) {
     glGenVertexArrays(1, &vertexArray);
     glGenBuffers(1, &arrayBuffer);
 
-    glBindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
 
     unsigned long arrayBufferSize = coords.size() * sizeof(float);
-    glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
     glBufferData(GL_ARRAY_BUFFER, static_cast<long> (arrayBufferSize), &coords.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
 
-int main() {
-    if (!glfwInit()) {
+// The function can be given as the first argument that is not an option, e.g. plot "sin(x / 10) * 1000"
+int main(int argc, char *argv[]) {
+    string formula = "x * x * x";
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]).rfind("--", 0) != 0) {
+            formula = argv[i];
+            break;
+        }
+    }
+    Expression functionToDisplay = Expression::parse(formula);
+    if (!functionToDisplay.isValid()) {
+        cout << functionToDisplay.getError() << endl;
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, TITLE);
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, TITLE);
+    if (!context.isCreated()) {
         return -1;
     }
 
-    auto functionToDisplay = [](float x) { return x * x * x; };
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    }
 
     unsigned int graphMetricVertexArray = createMetricVertexArray();
 
@@ -152,32 +161,31 @@ int main() {
     unsigned int graphVertexArray = createGraphVertexArray(coords);
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
     int colorUniformLocation = glGetUniformLocation(shader, "aColor");
     glUniform3f(colorUniformLocation, 0.0f, 1.0f, 0.0f);
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
-        processInput(window);
+        if (window) {
+            processInput(window);
+        }
 
-        glBindVertexArray(graphMetricVertexArray);
+        GlState::bindVertexArray(graphMetricVertexArray);
         glUniform3f(colorUniformLocation, 1.0f, 1.0f, 1.0f);
-        glDrawArrays(GL_LINES, 0, 12);
+        GlState::drawArrays(GL_LINES, 0, 12);
 
-        glBindVertexArray(graphVertexArray);
+        GlState::bindVertexArray(graphVertexArray);
         glUniform3f(colorUniformLocation, 1.0f, 0.0f, 0.0f);
         auto linesToDisplay = static_cast<int>(coords.size() / 2);
-        glDrawArrays(GL_LINE_STRIP, 0, linesToDisplay);
-
-        glfwSwapBuffers(window);
+        GlState::drawArrays(GL_LINE_STRIP, 0, linesToDisplay);
 
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
@@ -1,6 +1,10 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
+#include "expressionApi.h"
+#include <iostream>
 #include <vector>
 #include <string>
 #include <cmath>
@@ -31,16 +35,6 @@ void main(){
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -51,21 +45,21 @@ void processInput(GLFWwindow *window) {
     }
 }
 
-float functionToDisplay(float x) {
-    return x;
-}
+vector<float> generateCoords(float xStart, float xEnd, float step, const Expression &func) {
+    vector<float> xs;
+    for (float i = xStart; i <= xEnd;) {
+        xs.push_back(i);
+        i += step;
+    }
+    vector<float> ys(xs.size());
+    func.evaluate(xs.data(), nullptr, ys.data(), xs.size());
 
-template<class Function>
-vector<float> generateCoords(float xStart, float xEnd, float step, Function func) {
     vector<float> data;
-
-    for (float i = xStart; i <= xEnd;) {
-        float y = func(i);
-        data.push_back(i);
-        data.push_back(y);
+    data.reserve(xs.size() * 3);
+    for (size_t i = 0; i < xs.size(); i++) {
+        data.push_back(xs[i]);
+        data.push_back(ys[i]);
         data.push_back(0);
-
-        i += step;
     }
 
     return data;
@@ -95,19 +89,31 @@ void scaleCoords(vector<float> &data, float xScale, float yScale, float zScale)
     }
 }
 
-int main() {
-    if (!glfwInit()) {
+// The function can be given as the first argument that is not an option, e.g. trianglePlot "abs(x) - 5"
+int main(int argc, char *argv[]) {
+    string formula = "x";
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]).rfind("--", 0) != 0) {
+            formula = argv[i];
+            break;
+        }
+    }
+    Expression functionToDisplay = Expression::parse(formula);
+    if (!functionToDisplay.isValid()) {
+        cout << functionToDisplay.getError() << endl;
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, TITLE);
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, TITLE);
+    if (!context.isCreated()) {
         return -1;
     }
 
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    }
+
     std::vector<float> coords = generateCoords(-10.0f, 10.0f, 0.5f, functionToDisplay);
     std::vector<float> positions = generateLowerYCoord(coords);
     scaleCoords(positions, 10, 10, 1);
@@ -133,41 +139,40 @@ int main() {
     glGenBuffers(1, &arrayBuffer);
     glGenBuffers(1, &elementBuffer);
 
-    glBindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
 
     unsigned long arrayBufferSize = positions.size() * sizeof(float);
-    glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
     glBufferData(GL_ARRAY_BUFFER, static_cast<long> (arrayBufferSize), &positions.front(), GL_STATIC_DRAW);
 
     unsigned long elementBufferSize = indices.size() * sizeof(unsigned int);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long>(elementBufferSize), &indices.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
-        processInput(window);
+        if (window) {
+            processInput(window);
+        }
 
-        glBindVertexArray(vertexArray);
+        GlState::bindVertexArray(vertexArray);
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glDrawElements(GL_TRIANGLES, static_cast<int>(elementBufferSize / 3), GL_UNSIGNED_INT, nullptr);
-
-        glfwSwapBuffers(window);
+        GlState::drawElements(GL_TRIANGLES, static_cast<int>(elementBufferSize / 3), GL_UNSIGNED_INT, nullptr);
 
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
@@ -1,6 +1,8 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
 
@@ -30,16 +32,6 @@ void main(){
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -51,17 +43,15 @@ void processInput(GLFWwindow *window) {
 }
 
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, TITLE);
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, TITLE);
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
     std::vector<float> positions = {
@@ -79,7 +69,7 @@ int main() {
     unsigned int buffer;
     glGenBuffers(1, &buffer);
 
-    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, buffer);
     glBufferData(GL_ARRAY_BUFFER, 4 * 2 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
@@ -87,27 +77,26 @@ int main() {
 
     unsigned int indexBuffer;
     glGenBuffers(1, &indexBuffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(unsigned int), &indices.front(), GL_STATIC_DRAW);
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
-        processInput(window);
+        if (window) {
+            processInput(window);
+        }
 
         glClearColor(1.0f, 0.647f, 0.0f, 1.0f);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
-
-        glfwSwapBuffers(window);
+        GlState::drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
@@ -1,6 +1,8 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
 #include <cmath>
@@ -38,16 +40,6 @@ void main(){
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -69,61 +61,59 @@ unsigned int generateSquareVertexArray() {
     glGenBuffers(1, &squareVertexBuffer);
     glGenBuffers(1, &squareElementBuffer);
 
-    glBindVertexArray(squareVertexArray);
+    GlState::bindVertexArray(squareVertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, squareVertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, squareVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 12 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, squareElementBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, squareElementBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(unsigned int), &indices.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     return squareVertexArray;
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
     unsigned int squareVertexArray = generateSquareVertexArray();
     unsigned int shaderProgram = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shaderProgram);
+    GlState::useProgram(shaderProgram);
     int vertexColorLocation = glGetUniformLocation(shaderProgram, "color");
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
-        processInput(window);
+        if (window) {
+            processInput(window);
+        }
 
-        double timeValue = glfwGetTime();
+        double timeValue = context.getTime();
         double greenValue = sin(timeValue - (M_PI / 2)) / 2.0f + 0.5f;
         double redValue = cos(timeValue) / 2.0f + 0.5f;
         glUniform4f(vertexColorLocation, (float) redValue, (float) greenValue, 0.0f, 1.0f);
 
-        glBindVertexArray(squareVertexArray);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        GlState::bindVertexArray(squareVertexArray);
+        GlState::drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shaderProgram);
 
-    glfwTerminate();
     return 0;
 }
 
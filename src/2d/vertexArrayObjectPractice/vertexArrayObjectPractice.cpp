@@ -5,7 +5,9 @@ every time you want to draw something.
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
 
@@ -42,16 +44,6 @@ void main(){
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -70,15 +62,15 @@ unsigned int generateTriangleVertexArray() {
     glGenVertexArrays(1, &triangleVertexArray);
     glGenBuffers(1, &triangleVertexBuffer);
 
-    glBindVertexArray(triangleVertexArray);
-    glBindBuffer(GL_ARRAY_BUFFER, triangleVertexBuffer);
+    GlState::bindVertexArray(triangleVertexArray);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, triangleVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
 
     return triangleVertexArray;
 }
@@ -91,15 +83,15 @@ unsigned int generateSquareVertexArray() {
     glGenVertexArrays(1, &squareVertexArray);
     glGenBuffers(1, &squareVertexBuffer);
 
-    glBindVertexArray(squareVertexArray);
-    glBindBuffer(GL_ARRAY_BUFFER, squareVertexBuffer);
+    GlState::bindVertexArray(squareVertexArray);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, squareVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 12 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
 
     return squareVertexArray;
 }
@@ -113,31 +105,29 @@ unsigned int generateLeftTopTriangle() {
     glGenVertexArrays(1, &leftTopTriangleVertexArray);
     glGenBuffers(1, &leftTopTriangleVertexBuffer);
 
-    glBindVertexArray(leftTopTriangleVertexArray);
+    GlState::bindVertexArray(leftTopTriangleVertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, leftTopTriangleVertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, leftTopTriangleVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
 
     return leftTopTriangleVertexArray;
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
     unsigned int triangleVertexArray = generateTriangleVertexArray();
@@ -145,30 +135,29 @@ int main() {
     unsigned int leftTopTriangleVertexArray = generateLeftTopTriangle();
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
         glClearColor(1.0f, 0.647f, 0.0f, 1.0f);
-        processInput(window);
-
-        glBindVertexArray(triangleVertexArray);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        if (window) {
+            processInput(window);
+        }
 
-        glBindVertexArray(squareVertexArray);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        GlState::bindVertexArray(triangleVertexArray);
+        GlState::drawArrays(GL_TRIANGLES, 0, 3);
 
-        glBindVertexArray(leftTopTriangleVertexArray);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        GlState::bindVertexArray(squareVertexArray);
+        GlState::drawArrays(GL_TRIANGLES, 0, 6);
 
-        glfwSwapBuffers(window);
+        GlState::bindVertexArray(leftTopTriangleVertexArray);
+        GlState::drawArrays(GL_TRIANGLES, 0, 3);
 
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
@@ -1,9 +1,12 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
+#include "vertexLayout.h"
 #include <vector>
 #include <string>
-#include "texturesApi.h"
+#include "textureLoader.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -56,16 +59,6 @@ void main() {
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -76,52 +69,22 @@ void processInput(GLFWwindow *window) {
     }
 }
 
-unsigned int generateSquareVertexArray() {
-    vector<float> positions = getSquarePositions();
-    vector<unsigned int> indices = getSquareIndicesPositions();
-
-    unsigned int vertexArray;
-    unsigned int vertexBuffer;
-    unsigned int elementBuffer;
-    glGenVertexArrays(1, &vertexArray);
-    glGenBuffers(1, &vertexBuffer);
-    glGenBuffers(1, &elementBuffer);
-
-    glBindVertexArray(vertexArray);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, 32 * sizeof(float), &positions.front(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(unsigned int), &indices.front(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
+// Position, color and texture coordinates
+LayoutMesh generateSquareMesh() {
+    VertexLayout layout(VertexFormat().add(0, 3).add(1, 3).add(2, 2));
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    return vertexArray;
+    return VertexArrayCache::upload(layout, getSquarePositions(), getSquareIndicesPositions());
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -129,15 +92,17 @@ int main() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    unsigned int squareVertexArray = generateSquareVertexArray();
+    LayoutMesh squareMesh = generateSquareMesh();
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
-    unsigned int texture1 = bindTextureRGB(
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/container.jpg");
-    unsigned int texture2 = bindTextureRGBA(
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/awesomeface.png");
+    // Both textures show the placeholder until their upload, a frame or two after the first one
+    TextureLoader textureLoader;
+    unsigned int texture1 = textureLoader.load(
+            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/container.jpg", 3);
+    unsigned int texture2 = textureLoader.load(
+            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/awesomeface.png", 4);
 
     int texture1UniformLocation = glGetUniformLocation(shader, "texture1");
     glUniform1i(texture1UniformLocation, 0);
@@ -162,27 +127,23 @@ int main() {
     glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
 
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
-        processInput(window);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture1);
-
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, texture2);
+        if (window) {
+            processInput(window);
+        }
 
-        glBindVertexArray(squareVertexArray);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        textureLoader.update();
+        GlState::bindTexture(0, GL_TEXTURE_2D, texture1);
+        GlState::bindTexture(1, GL_TEXTURE_2D, texture2);
 
-        glfwSwapBuffers(window);
+        VertexArrayCache::draw(squareMesh, GL_TRIANGLES);
 
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
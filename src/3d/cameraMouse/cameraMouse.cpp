@@ -1,9 +1,12 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
-#include "texturesApi.h"
+#include "textureCache.h"
+#include "meshApi.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -40,15 +43,15 @@ const string VERTEX_SHADER = R"glsl(
 
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec2 aTexCoord;
+layout(location = 3) in mat4 instanceModel;
 
 out vec2 TexCoord;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main(){
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * instanceModel * vec4(aPos, 1.0);
     TexCoord = aTexCoord;
 }
 )glsl";
@@ -68,16 +71,6 @@ void main() {
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -152,9 +145,9 @@ unsigned int generateCubeVertexArray() {
     glGenVertexArrays(1, &vertexArray);
     glGenBuffers(1, &vertexBuffer);
 
-    glBindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
     unsigned long vertexBufferSize = positions.size() * sizeof(float);
     glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
 
@@ -165,40 +158,38 @@ unsigned int generateCubeVertexArray() {
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
     }
 
     unsigned int cubeVertexArray = generateCubeVertexArray();
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    unsigned int texture1 = bindTextureRGB(
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/container.jpg");
-    unsigned int texture2 = bindTextureRGBA(
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/awesomeface.png");
+    TextureHandle texture1 = TextureCache::load(
+            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/container.jpg", 3);
+    TextureHandle texture2 = TextureCache::load(
+            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/awesomeface.png", 4);
 
     int texture1UniformLocation = glGetUniformLocation(shader, "texture1");
     glUniform1i(texture1UniformLocation, 0);
@@ -211,12 +202,13 @@ int main() {
     int projectionLocation = glGetUniformLocation(shader, "projection");
     glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
 
-    int modelLocation = glGetUniformLocation(shader, "model");
     int viewLocation = glGetUniformLocation(shader, "view");
 
     glEnable(GL_DEPTH_TEST);
 
     vector<glm::vec3> modelPositions = getModelPositions();
+    InstancedMesh cubes(cubeVertexArray, 36);
+    vector<glm::mat4> models(modelPositions.size());
 
     globalCamera = {
             glm::vec3(0.0f, 0.0f, 3.0f),
@@ -226,44 +218,43 @@ int main() {
             0.0f
     };
 
-    while (!glfwWindowShouldClose(window)) {
-        processInput(window);
+    while (!context.shouldClose()) {
+        if (window) {
+            processInput(window);
+        }
 
-        auto currentFrame = static_cast<float> (glfwGetTime());
+        auto currentFrame = static_cast<float> (context.getTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        processCameraInput(window, globalCamera);
+        if (window) {
+            processCameraInput(window, globalCamera);
+        }
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture1);
+        GlState::bindTexture(0, GL_TEXTURE_2D, texture1->getTexture());
 
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, texture2);
+        GlState::bindTexture(1, GL_TEXTURE_2D, texture2->getTexture());
 
-        glBindVertexArray(cubeVertexArray);
         for (size_t i = 0; i < modelPositions.size(); i++) {
             auto model = glm::mat4(1.0f);
             model = glm::translate(model, modelPositions[i]);
             float angle = 20.0f * static_cast<float>(i + 1);
-            model = glm::rotate(model, (float) glfwGetTime() * glm::radians(angle), glm::vec3(0.5f, 1.0f, 0.0f));
-            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            model = glm::rotate(model, (float) context.getTime() * glm::radians(angle), glm::vec3(0.5f, 1.0f, 0.0f));
+            models[i] = model;
         }
+        cubes.setTransforms(models);
+        cubes.draw();
 
         glm::mat4 view = generateLookAtMatrix(globalCamera);
         glUniformMatrix4fv(viewLocation, 1, GL_FALSE, glm::value_ptr(view));
 
-        glfwSwapBuffers(window);
-
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
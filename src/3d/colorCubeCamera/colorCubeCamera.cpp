@@ -1,6 +1,8 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include "cameraApi.h"
 #include <vector>
 #include <string>
@@ -9,10 +11,6 @@
 
 using namespace std;
 
-struct GraphicContext {
-    GLFWwindow *window;
-};
-
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
@@ -63,16 +61,6 @@ void main() {
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -103,13 +91,13 @@ unsigned int generateCubeVertexArray() {
     glGenBuffers(1, &vertexBuffer);
     glGenBuffers(1, &elementBuffer);
 
-    glBindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
     unsigned long vertexBufferSize = positions.size() * sizeof(float);
     glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
     unsigned long elementBufferSize = indices.size() * sizeof(unsigned int);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long> (elementBufferSize), &indices.front(), GL_STATIC_DRAW);
 
@@ -120,69 +108,66 @@ unsigned int generateCubeVertexArray() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
 
-void graphicLogic(const GraphicContext &context) {
+void graphicLogic(RenderContext &context) {
     ShaderProgram shaderProgram = ShaderProgram::createShaderProgramFromStrings(VERTEX_SHADER, FRAGMENT_SHADER);
     shaderProgram.use();
 
     unsigned int cubeVertexArray = generateCubeVertexArray();
 
-    while (!glfwWindowShouldClose(context.window)) {
-        float currentFrame = glfwGetTime();
+    while (!context.shouldClose()) {
+        float currentFrame = context.getTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        processInput(context.window);
+        if (context.getWindow()) {
+            processInput(context.getWindow());
+        }
 
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float) WIDTH / (float) HEIGHT, 0.1f,100.0f);
-        shaderProgram.setMat4("projection", projection);
+        shaderProgram.setMat4("projection"_u, projection);
 
         glm::mat4 view = camera.GetViewMatrix();
-        shaderProgram.setMat4("view", view);
+        shaderProgram.setMat4("view"_u, view);
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         auto model = glm::mat4(1.0f);
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
         model = glm::translate(model, glm::vec3(0.0f, 0.0f, -2.0f));
-        shaderProgram.setMat4("model", model);
+        shaderProgram.setMat4("model"_u, model);
 
-        glBindVertexArray(cubeVertexArray);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+        GlState::bindVertexArray(cubeVertexArray);
+        GlState::drawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
 
-        glfwSwapBuffers(context.window);
-
-        glfwPollEvents();
+        context.swapBuffers();
     }
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
     glEnable(GL_DEPTH_TEST);
 
-    GraphicContext graphicContext{window};
-    graphicLogic(graphicContext);
+    graphicLogic(context);
 
-    glfwTerminate();
     return 0;
 }
 
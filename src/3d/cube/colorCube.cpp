@@ -1,6 +1,8 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <vector>
 #include <string>
 #include <glm/glm.hpp>
@@ -9,10 +11,6 @@
 using namespace std;
 
 
-struct GraphicContext {
-    GLFWwindow *window;
-};
-
 const GLint WIDTH = 640;
 const GLint HEIGHT = 480;
 
@@ -52,16 +50,6 @@ void main() {
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -84,13 +72,13 @@ unsigned int generateCubeVertexArray() {
     glGenBuffers(1, &vertexBuffer);
     glGenBuffers(1, &elementBuffer);
 
-    glBindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
     unsigned long vertexBufferSize = positions.size() * sizeof(float);
     glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
     unsigned long elementBufferSize = indices.size() * sizeof(unsigned int);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long> (elementBufferSize), &indices.front(), GL_STATIC_DRAW);
 
@@ -101,14 +89,14 @@ unsigned int generateCubeVertexArray() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
 
-void graphicLogic(const GraphicContext &context) {
+void graphicLogic(RenderContext &context) {
     unsigned int cubeVertexArray = generateCubeVertexArray();
 
     ShaderProgram shaderProgram = ShaderProgram::createShaderProgramFromStrings(VERTEX_SHADER, FRAGMENT_SHADER);
@@ -116,49 +104,45 @@ void graphicLogic(const GraphicContext &context) {
 
     auto view = glm::mat4(1.0f);
     view = glm::translate(view, glm::vec3(0.0f, 0.0f, -3.0f));
-    shaderProgram.setMat4("view", view);
+    shaderProgram.setMat4("view"_u, view);
 
     glm::mat4 projection;
     projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
-    shaderProgram.setMat4("projection", projection);
+    shaderProgram.setMat4("projection"_u, projection);
 
     glEnable(GL_DEPTH_TEST);
 
-    while (!glfwWindowShouldClose(context.window)) {
-        processInput(context.window);
+    while (!context.shouldClose()) {
+        if (context.getWindow()) {
+            processInput(context.getWindow());
+        }
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         auto model = glm::mat4(1.0f);
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
-        shaderProgram.setMat4("model", model);
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
+        shaderProgram.setMat4("model"_u, model);
 
-        glBindVertexArray(cubeVertexArray);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+        GlState::bindVertexArray(cubeVertexArray);
+        GlState::drawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
 
-        glfwSwapBuffers(context.window);
-
-        glfwPollEvents();
+        context.swapBuffers();
     }
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
-    GraphicContext graphicContext{window};
-    graphicLogic(graphicContext);
+    graphicLogic(context);
 
-    glfwTerminate();
     return 0;
 }
 
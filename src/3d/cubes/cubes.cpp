@@ -1,9 +1,14 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include <cmath>
+#include <cstdlib>
 #include <vector>
 #include <string>
-#include "texturesApi.h"
+#include "textureLoader.h"
+#include "meshApi.h"
+#include "glStateApi.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -17,22 +22,22 @@ string getTitle();
 
 vector<float> getCubePositions();
 
-vector<glm::vec3> getModelPositions();
+vector<glm::vec3> getModelPositions(size_t count);
 
 const string VERTEX_SHADER = R"glsl(
 #version 330 core
 
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec2 aTexCoord;
+layout(location = 3) in mat4 instanceModel;
 
 out vec2 TexCoord;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main(){
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * instanceModel * vec4(aPos, 1.0);
     TexCoord = aTexCoord;
 }
 )glsl";
@@ -52,16 +57,6 @@ void main() {
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -80,9 +75,9 @@ unsigned int generateCubeVertexArray() {
     glGenVertexArrays(1, &vertexArray);
     glGenBuffers(1, &vertexBuffer);
 
-    glBindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
     unsigned long vertexBufferSize = positions.size() * sizeof(float);
     glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
 
@@ -93,39 +88,40 @@ unsigned int generateCubeVertexArray() {
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
 
-int main() {
-    if (!glfwInit()) {
+// Usage: cubes [count] [context options], e.g. "cubes 100000" for a stress test of the instanced path
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
     unsigned int cubeVertexArray = generateCubeVertexArray();
 
     unsigned int shader = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shader);
+    GlState::useProgram(shader);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    unsigned int texture1 = bindTextureRGB(
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/container.jpg");
-    unsigned int texture2 = bindTextureRGBA(
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/awesomeface.png");
+    // Both textures show the placeholder until their upload, a frame or two after the first one
+    TextureLoader textureLoader;
+    unsigned int texture1 = textureLoader.load(
+            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/container.jpg", 3);
+    unsigned int texture2 = textureLoader.load(
+            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/awesomeface.png", 4);
 
     int texture1UniformLocation = glGetUniformLocation(shader, "texture1");
     glUniform1i(texture1UniformLocation, 0);
@@ -143,41 +139,46 @@ int main() {
     int projectionLocation = glGetUniformLocation(shader, "projection");
     glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
 
-    int modelLocation = glGetUniformLocation(shader, "model");
-
     glEnable(GL_DEPTH_TEST);
 
-    vector<glm::vec3> modelPositions = getModelPositions();
+    size_t cubeCount = 10;
+    for (int i = 1; i < argc; i++) {
+        // Like the context options this uses atoi, so an argument that is not a positive number keeps the default
+        int parsedCount = atoi(argv[i]);
+        if (string(argv[i]).rfind("--", 0) != 0 && parsedCount > 0) {
+            cubeCount = parsedCount;
+        }
+    }
+    vector<glm::vec3> modelPositions = getModelPositions(cubeCount);
+    InstancedMesh cubes(cubeVertexArray, 36);
+    vector<glm::mat4> models(modelPositions.size());
 
-    while (!glfwWindowShouldClose(window)) {
-        processInput(window);
+    while (!context.shouldClose()) {
+        if (window) {
+            processInput(window);
+        }
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture1);
-
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, texture2);
+        textureLoader.update();
+        GlState::bindTexture(0, GL_TEXTURE_2D, texture1);
+        GlState::bindTexture(1, GL_TEXTURE_2D, texture2);
 
-        glBindVertexArray(cubeVertexArray);
         for (size_t i = 0; i < modelPositions.size(); i++) {
             auto model = glm::mat4(1.0f);
             model = glm::translate(model, modelPositions[i]);
             float angle = 20.0f * static_cast<float>(i + 1);
-            model = glm::rotate(model, (float) glfwGetTime() * glm::radians(angle), glm::vec3(0.5f, 1.0f, 0.0f));
-            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            model = glm::rotate(model, (float) context.getTime() * glm::radians(angle), glm::vec3(0.5f, 1.0f, 0.0f));
+            models[i] = model;
         }
+        cubes.setTransforms(models);
+        cubes.draw();
 
-        glfwSwapBuffers(window);
-
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     glDeleteProgram(shader);
 
-    glfwTerminate();
     return 0;
 }
 
@@ -230,7 +231,7 @@ vector<float> getCubePositions() {
     return positions;
 }
 
-vector<glm::vec3> getModelPositions() {
+vector<glm::vec3> getModelPositions(size_t count) {
     vector<glm::vec3> positions = {
             glm::vec3(0.0f, 0.0f, 0.0f),
             glm::vec3(2.0f, 5.0f, -15.0f),
@@ -244,6 +245,19 @@ vector<glm::vec3> getModelPositions() {
             glm::vec3(-1.3f, 1.0f, -1.5f)
     };
 
+    // Anything past the hand-placed cubes fills a grid behind them, within the far plane
+    size_t handPlaced = positions.size();
+    auto side = static_cast<size_t>(ceil(cbrt(static_cast<double>(count))));
+    const float spacing = 1.5f;
+    for (size_t i = handPlaced; i < count; i++) {
+        size_t index = i - handPlaced;
+        float x = static_cast<float>(index % side) - static_cast<float>(side) / 2.0f;
+        float y = static_cast<float>(index / side % side) - static_cast<float>(side) / 2.0f;
+        float z = static_cast<float>(index / (side * side));
+        positions.emplace_back(x * spacing, y * spacing, -20.0f - z * spacing);
+    }
+    positions.resize(count);
+
     return positions;
 }
 
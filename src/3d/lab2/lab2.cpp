@@ -1,19 +1,26 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
 #include "cameraApi.h"
+#include "glStateApi.h"
+#include "profilerApi.h"
+#include "heightFieldMesher.h"
+#include "gpuHeightField.h"
+#include "chunkedSurface.h"
+#include "parametricMesher.h"
+#include "vertexLayout.h"
+#include "expressionApi.h"
 #include <vector>
 #include <string>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <cmath>
+#include <iostream>
+#include <memory>
 
 using namespace std;
 
-struct GraphicContext {
-    GLFWwindow *window;
-};
-
 struct GraphData {
     unsigned int vertexArray;
     int vertexToDraw;
@@ -31,6 +38,19 @@ float lastY = HEIGHT / 2.0f;
 
 glm::mat4 projection;
 
+const HeightFieldGrid GRAPH1_GRID{-3.0f, 3.0f, 0.1f};
+const HeightFieldGrid GRAPH2_GRID{-4.0f, 4.0f, 0.1f};
+const glm::vec3 GRAPH_COLOR(1.0f, 0.0f, 0.0f);
+
+// The built-in surfaces as GLSL, for --gpu-graphs
+const string GRAPH1_GLSL = "x * x + y * y";
+const string GRAPH2_GLSL = "sqrt(max(x, 0.0)) + sqrt(max(y, 0.0))";
+
+// "--terrain" or "--terrain=<formula>" adds a large chunked surface below the scene
+const string TERRAIN_FORMULA = "2 * sin(x / 4) * cos(y / 4)";
+const float TERRAIN_START = -512.0f;
+const float TERRAIN_END = 512.0f;
+
 string getTitle();
 
 vector<float> getCubePositions();
@@ -50,8 +70,13 @@ layout(location = 1) in vec3 aColor;
 out vec3 color;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+layout (std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 
 void main(){
     gl_Position = projection * view * model * vec4(aPos, 1.0);
@@ -71,16 +96,6 @@ void main() {
 }
 )glsl";
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -107,371 +122,264 @@ void processInput(GLFWwindow *window) {
                                       100.0f);
 }
 
-unsigned int generateCubeVertexArray() {
-    vector<float> positions = getCubePositions();
-    vector<unsigned int> indices = getCubeIndices();
-
-    unsigned int vertexArray;
-    unsigned int vertexBuffer;
-    unsigned int elementBuffer;
-
-    glGenVertexArrays(1, &vertexArray);
-    glGenBuffers(1, &vertexBuffer);
-    glGenBuffers(1, &elementBuffer);
-
-    glBindVertexArray(vertexArray);
+LayoutMesh generateCubeMesh() {
+    VertexLayout layout(VertexFormat::compactPositionColor());
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    unsigned long vertexBufferSize = positions.size() * sizeof(float);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
-    unsigned long elementBufferSize = indices.size() * sizeof(unsigned int);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long> (elementBufferSize), &indices.front(), GL_STATIC_DRAW);
-
-    int strideSize = 6 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strideSize, nullptr);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    return VertexArrayCache::upload(layout, getCubePositions(), getCubeIndices());
+}
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+GraphData uploadGraph(const HeightFieldMesh &mesh) {
+    HeightFieldBuffers buffers = HeightFieldMesher::upload(mesh);
 
-    return vertexArray;
+    return {buffers.vertexArray, buffers.indexCount};
 }
 
-GraphData generateGraph1VertexArray() {
-    vector<float> positions;
-
-    auto func = [](float x, float y) {
-        return x * x + y * y;
-    };
-    float start = -3.0f;
-    float end = 3.0f;
-    float step = 0.1f;
-
-    for (float x = start; x < end;) {
-        for (float y = start; y < end;) {
-            positions.push_back(x);
-            positions.push_back(func(x, y));
-            positions.push_back(y);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x);
-            positions.push_back(func(x, y + step));
-            positions.push_back(y + step);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x + step);
-            positions.push_back(func(x + step, y + step));
-            positions.push_back(y + step);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x);
-            positions.push_back(func(x, y));
-            positions.push_back(y);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x + step);
-            positions.push_back(func(x + step, y));
-            positions.push_back(y);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x + step);
-            positions.push_back(func(x + step, y + step));
-            positions.push_back(y + step);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            y += step;
+// Builds the surface from a formula when one was given and parses, otherwise from the built-in function
+template<class Function>
+GraphData generateGraphVertexArray(const string &formula, const HeightFieldGrid &grid, Function func) {
+    if (!formula.empty()) {
+        Expression expression = Expression::parse(formula);
+        if (expression.isValid()) {
+            return uploadGraph(HeightFieldMesher::generateParallel(expression, grid, GRAPH_COLOR));
         }
-        x += step;
+        cout << expression.getError() << endl;
     }
 
-    int vertexToDraw = pow((abs(start) + abs(end)) / step, 2) * 6;
-
-    unsigned int vertexArray;
-    unsigned int vertexBuffer;
-
-    glGenVertexArrays(1, &vertexArray);
-    glGenBuffers(1, &vertexBuffer);
-
-    glBindVertexArray(vertexArray);
+    return uploadGraph(HeightFieldMesher::generateParallel(func, grid, GRAPH_COLOR));
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    unsigned long vertexBufferSize = positions.size() * sizeof(float);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
+GraphData generateGraph1VertexArray(const string &formula) {
+    auto func = [](FloatLanes x, FloatLanes y) {
+        return x * x + y * y;
+    };
 
-    int strideSize = 6 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strideSize, nullptr);
-    glEnableVertexAttribArray(0);
+    return generateGraphVertexArray(formula, GRAPH1_GRID, func);
+}
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+GraphData generateGraph2VertexArray(const string &formula) {
+    // Negative coordinates are clamped to zero before the square root
+    auto func = [](FloatLanes x, FloatLanes y) {
+        FloatLanes zero = FloatLanes::broadcast(0.0f);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return FloatLanes::sqrt(FloatLanes::max(x, zero)) + FloatLanes::sqrt(FloatLanes::max(y, zero));
+    };
 
-    return {vertexArray, vertexToDraw};
+    return generateGraphVertexArray(formula, GRAPH2_GRID, func);
 }
 
-GraphData generateGraph2VertexArray() {
-    vector<float> positions;
-
-    auto func = [](float x, float y) {
-        if (x < 0) {
-            x = 0.0f;
-        }
-
-        if (y < 0) {
-            y = 0.0f;
+// Same fallback as generateGraphVertexArray, but the surface is computed in the vertex shader
+unique_ptr<GpuHeightField> createGpuGraph(const string &formula, const string &builtInGlsl,
+                                          const HeightFieldGrid &grid) {
+    string glsl = builtInGlsl;
+    if (!formula.empty()) {
+        Expression expression = Expression::parse(formula);
+        if (expression.isValid()) {
+            glsl = expression.toGlsl();
+        } else {
+            cout << expression.getError() << endl;
         }
+    }
 
-        return sqrt(x) + sqrt(y);
-    };
+    return make_unique<GpuHeightField>(glsl, grid, GRAPH_COLOR);
+}
 
-    float start = -4.0f;
-    float end = 4.0f;
-    float step = 0.1f;
-
-    for (float x = start; x < end;) {
-        for (float y = start; y < end;) {
-            positions.push_back(x);
-            positions.push_back(func(x, y));
-            positions.push_back(y);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x);
-            positions.push_back(func(x, y + step));
-            positions.push_back(y + step);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x + step);
-            positions.push_back(func(x + step, y + step));
-            positions.push_back(y + step);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x);
-            positions.push_back(func(x, y));
-            positions.push_back(y);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x + step);
-            positions.push_back(func(x + step, y));
-            positions.push_back(y);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            positions.push_back(x + step);
-            positions.push_back(func(x + step, y + step));
-            positions.push_back(y + step);
-            positions.push_back(1.0f);
-            positions.push_back(0.0f);
-            positions.push_back(0.0f);
-
-            y += step;
+// "--graph1=<formula>" and "--graph2=<formula>" replace the built-in surfaces, e.g. --graph1="sin(x) * cos(y)"
+string getGraphFormula(int argc, char *argv[], const string &option) {
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument.rfind(option, 0) == 0) {
+            return argument.substr(option.size());
         }
-        x += step;
     }
+    return "";
+}
 
-    int vertexToDraw = pow((abs(start) + abs(end)) / step, 2) * 6;
-
-    unsigned int vertexArray;
-    unsigned int vertexBuffer;
-
-    glGenVertexArrays(1, &vertexArray);
-    glGenBuffers(1, &vertexBuffer);
-
-    glBindVertexArray(vertexArray);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    unsigned long vertexBufferSize = positions.size() * sizeof(float);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
-
-    int strideSize = 6 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strideSize, nullptr);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+unique_ptr<ChunkedSurface> createTerrain(const string &formula) {
+    if (formula.empty()) {
+        return nullptr;
+    }
 
-    return {vertexArray, vertexToDraw};
+    Expression expression = Expression::parse(formula);
+    if (!expression.isValid()) {
+        cout << expression.getError() << endl;
+        expression = Expression::parse(TERRAIN_FORMULA);
+    }
+    return make_unique<ChunkedSurface>(expression, TERRAIN_START, TERRAIN_END, GRAPH1_GRID.step, GRAPH_COLOR);
 }
 
-GraphData generateTorusVertexArray(double r = 0.07, double c = 0.15, int rSeg = 16, int cSeg = 36) {
-    vector<float> positions;
-
-    const double PI = 3.1415926535897932384626433832795;
-    const double TAU = 2 * PI;
-
-    for (int i = 0; i < 64; i++) {
-        for (int j = 0; j <= cSeg; j++) {
-            for (int k = 0; k <= 1; k++) {
-                double s = (i + k) % rSeg + 0.5;
-                double t = j % (cSeg + 1);
-
-                double x = (c + r * cos(s * TAU / rSeg)) * cos(t * TAU / cSeg);
-                double y = (c + r * cos(s * TAU / rSeg)) * sin(t * TAU / cSeg);
-                double z = r * sin(s * TAU / rSeg);
-
-                positions.push_back(2 * x);
-                positions.push_back(2 * y);
-                positions.push_back(2 * z);
-                positions.push_back(0.0f);
-                positions.push_back(1.0f);
-                positions.push_back(0.0f);
-            }
+// "--gpu-graphs" draws both surfaces from one shared unit grid with the height computed in the vertex shader
+bool hasOption(int argc, char *argv[], const string &option) {
+    for (int i = 1; i < argc; i++) {
+        if (argv[i] == option) {
+            return true;
         }
     }
+    return false;
+}
 
-    int vertexCount = positions.size() / 6;
-
-    unsigned int vertexArray;
-    unsigned int vertexBuffer;
-
-    glGenVertexArrays(1, &vertexArray);
-    glGenBuffers(1, &vertexBuffer);
-
-    glBindVertexArray(vertexArray);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    unsigned long vertexBufferSize = positions.size() * sizeof(float);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
-
-    int strideSize = 6 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strideSize, nullptr);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+// lab2's shader reads a color from attribute 1, so the normals are switched off there and the color comes from
+// the generic attribute value set before each draw
+ParametricMeshBuffers generateTorusBuffers() {
+    ParametricMeshBuffers buffers = ParametricMesher::upload(ParametricMesher::torus(0.3f, 0.14f, 36, 16));
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(buffers.vertexArray);
+    glDisableVertexAttribArray(1);
+    GlState::bindVertexArray(0);
 
-    return {vertexArray, vertexCount};
+    return buffers;
 }
 
-void graphicLogic(const GraphicContext &context) {
+void graphicLogic(RenderContext &context, const string &graph1Formula, const string &graph2Formula,
+                  bool gpuGraphs, const string &terrainFormula) {
     ShaderProgram shaderProgram = ShaderProgram::createShaderProgramFromStrings(VERTEX_SHADER, FRAGMENT_SHADER);
     shaderProgram.use();
 
-    unsigned int cubeVertexArray = generateCubeVertexArray();
-
-    GraphData graphic1Data = generateGraph1VertexArray();
-    GraphData graphic2Data = generateGraph2VertexArray();
-    GraphData torusData = generateTorusVertexArray();
+    LayoutMesh cubeMesh = generateCubeMesh();
+
+    GraphData graphic1Data{0, 0};
+    GraphData graphic2Data{0, 0};
+    unique_ptr<GpuHeightField> gpuGraphic1;
+    unique_ptr<GpuHeightField> gpuGraphic2;
+    if (gpuGraphs) {
+        gpuGraphic1 = createGpuGraph(graph1Formula, GRAPH1_GLSL, GRAPH1_GRID);
+        gpuGraphic2 = createGpuGraph(graph2Formula, GRAPH2_GLSL, GRAPH2_GRID);
+    } else {
+        graphic1Data = generateGraph1VertexArray(graph1Formula);
+        graphic2Data = generateGraph2VertexArray(graph2Formula);
+    }
+    ParametricMeshBuffers torusBuffers = generateTorusBuffers();
+    unique_ptr<ChunkedSurface> terrain = createTerrain(terrainFormula);
 
     projection = glm::perspective(glm::radians(camera.Zoom), (float) WIDTH / (float) HEIGHT, 0.1f, 100.0f);
 
-    while (!glfwWindowShouldClose(context.window)) {
-        float currentFrame = glfwGetTime();
+    // camera data written once per frame instead of set on the program
+    UniformBuffer cameraBuffer = UniformBuffer::create("Camera", sizeof(CameraBlock));
+
+    while (!context.shouldClose()) {
+        float currentFrame = context.getTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        processInput(context.window);
-
-        shaderProgram.setMat4("projection", projection);
+        if (context.getWindow()) {
+            processInput(context.getWindow());
+        }
 
         glm::mat4 view = camera.GetViewMatrix();
-        shaderProgram.setMat4("view", view);
+        cameraBuffer.update(CameraBlock{projection, view, camera.Position});
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         //      Cube 1
+        Profiler::beginScope("cube 1");
         auto model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(2.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
-        shaderProgram.setMat4("model", model);
-        glBindVertexArray(cubeVertexArray);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
+        shaderProgram.setMat4("model"_u, model);
+        VertexArrayCache::bind(cubeMesh);
+        GlState::polygonMode(GL_FILL);
+        GlState::drawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+        Profiler::endScope();
 
         //      Cube 2
+        Profiler::beginScope("cube 2");
         model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(-2.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
-        shaderProgram.setMat4("model", model);
-        glBindVertexArray(cubeVertexArray);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
+        shaderProgram.setMat4("model"_u, model);
+        VertexArrayCache::bind(cubeMesh);
+        GlState::polygonMode(GL_LINE);
+        GlState::drawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+        Profiler::endScope();
 
         //      Graph 1
+        Profiler::beginScope("graph 1");
         model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(5.0f, 0.0f, -10.0f));
-        shaderProgram.setMat4("model", model);
-        glBindVertexArray(graphic1Data.vertexArray);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glDrawArrays(GL_TRIANGLES, 0, graphic1Data.vertexToDraw);
+        GlState::polygonMode(GL_LINE);
+        if (gpuGraphic1) {
+            gpuGraphic1->draw(model, view, projection);
+            shaderProgram.use();
+        } else {
+            shaderProgram.setMat4("model"_u, model);
+            GlState::bindVertexArray(graphic1Data.vertexArray);
+            GlState::drawElements(GL_TRIANGLES, graphic1Data.vertexToDraw, GL_UNSIGNED_INT, nullptr);
+        }
+        Profiler::endScope();
 
         //      Graph 2
+        Profiler::beginScope("graph 2");
         model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(-5.0f, 0.0f, -10.0f));
-        shaderProgram.setMat4("model", model);
-        glBindVertexArray(graphic2Data.vertexArray);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glDrawArrays(GL_TRIANGLES, 0, graphic2Data.vertexToDraw);
-
+        GlState::polygonMode(GL_LINE);
+        if (gpuGraphic2) {
+            gpuGraphic2->draw(model, view, projection);
+            shaderProgram.use();
+        } else {
+            shaderProgram.setMat4("model"_u, model);
+            GlState::bindVertexArray(graphic2Data.vertexArray);
+            GlState::drawElements(GL_TRIANGLES, graphic2Data.vertexToDraw, GL_UNSIGNED_INT, nullptr);
+        }
+        Profiler::endScope();
 
+        //      Torus
+        Profiler::beginScope("torus");
         model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));
-        shaderProgram.setMat4("model", model);
-        glBindVertexArray(torusData.vertexArray);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glDrawArrays(GL_LINE_STRIP, 0, torusData.vertexToDraw);
+        shaderProgram.setMat4("model"_u, model);
+        GlState::polygonMode(GL_LINE);
+        // The cubes draw with array 1 enabled, which leaves the generic value undefined
+        glVertexAttrib3f(1, 0.0f, 1.0f, 0.0f);
+        ParametricMesher::draw(torusBuffers);
+        Profiler::endScope();
+
+        //      Terrain
+        if (terrain) {
+            Profiler::beginScope("terrain");
+            model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3(0.0f, -5.0f, 0.0f));
+            GlState::polygonMode(GL_LINE);
+            terrain->draw(model, view, projection, camera.Position);
+            shaderProgram.use();
+            Profiler::endScope();
+        }
 
-        glfwSwapBuffers(context.window);
+        context.swapBuffers();
+    }
 
-        glfwPollEvents();
+    if (terrain) {
+        ChunkedSurfaceStats terrainStats = terrain->getStats();
+        cout << "Terrain chunks drawn: " << terrainStats.chunks << ", culled: " << terrainStats.culledChunks
+             << ", triangles: " << terrainStats.triangles << endl;
     }
+
+    GlStateCounters stateCounters = GlState::getCounters();
+    cout << "GL state calls issued: " << stateCounters.issued << ", skipped: " << stateCounters.skipped << endl;
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
     glEnable(GL_DEPTH_TEST);
 
-    GraphicContext graphicContext{window};
-    graphicLogic(graphicContext);
+    string terrainFormula = getGraphFormula(argc, argv, "--terrain=");
+    if (terrainFormula.empty() && hasOption(argc, argv, "--terrain")) {
+        terrainFormula = TERRAIN_FORMULA;
+    }
+
+    graphicLogic(context, getGraphFormula(argc, argv, "--graph1="), getGraphFormula(argc, argv, "--graph2="),
+                 hasOption(argc, argv, "--gpu-graphs"), terrainFormula);
 
-    glfwTerminate();
     return 0;
 }
 
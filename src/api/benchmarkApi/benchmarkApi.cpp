@@ -0,0 +1,151 @@
+#include "benchmarkApi.h"
+#include "glStateApi.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+using namespace std;
+
+FrameBenchmark::FrameBenchmark(int warmupFrames, int measuredFrames)
+        : warmupFrames(warmupFrames), measuredFrames(measuredFrames), frameIndex(-1), isQueryActive(false),
+          frameStartDraws(0) {
+    bool isGpuTimerSupported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (isGpuTimerSupported && measuredFrames > 0) {
+        queries.resize(measuredFrames);
+        glGenQueries(measuredFrames, queries.data());
+    }
+    cpuMillis.reserve(measuredFrames);
+    drawCalls.reserve(measuredFrames);
+}
+
+FrameBenchmark::~FrameBenchmark() {
+    if (!queries.empty()) {
+        glDeleteQueries(static_cast<int>(queries.size()), queries.data());
+    }
+}
+
+bool FrameBenchmark::isMeasuring() const {
+    return frameIndex >= warmupFrames && frameIndex < warmupFrames + measuredFrames;
+}
+
+void FrameBenchmark::endFrame() {
+    if (isQueryActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+        isQueryActive = false;
+    }
+    if (isMeasuring()) {
+        drawCalls.push_back(static_cast<double>(GlState::getCounters().draws - frameStartDraws));
+    }
+}
+
+void FrameBenchmark::beginFrame() {
+    auto now = chrono::steady_clock::now();
+    if (isMeasuring()) {
+        cpuMillis.push_back(chrono::duration<double, milli>(now - frameStart).count());
+    }
+
+    frameIndex++;
+    frameStart = now;
+    frameStartDraws = GlState::getCounters().draws;
+
+    if (isMeasuring() && !queries.empty()) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[frameIndex - warmupFrames]);
+        isQueryActive = true;
+    }
+}
+
+bool FrameBenchmark::isDone() const {
+    return frameIndex >= warmupFrames + measuredFrames;
+}
+
+int FrameBenchmark::getTotalFrames() const {
+    return warmupFrames + measuredFrames;
+}
+
+// Only frames that were actually ended have a result; a window closed early leaves the rest unused
+void FrameBenchmark::collectGpuTimes() {
+    gpuMillis.clear();
+    for (size_t i = 0; i < drawCalls.size() && i < queries.size(); i++) {
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &nanoseconds);
+        gpuMillis.push_back(static_cast<double>(nanoseconds) / 1.0e6);
+    }
+}
+
+// Percentiles use the nearest-rank method, so every reported value is a frame that really happened
+FrameStatistics FrameBenchmark::calculateStatistics(vector<double> samples) {
+    if (samples.empty()) {
+        return {0.0, 0.0, 0.0, 0.0, 0.0};
+    }
+
+    sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double percent) {
+        auto rank = static_cast<size_t>(ceil(percent / 100.0 * static_cast<double>(samples.size())));
+        return samples[max<size_t>(rank, 1) - 1];
+    };
+    double mean = accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    return {mean, percentile(50), percentile(95), percentile(99), samples.back()};
+}
+
+string escapeJson(const string &value) {
+    string escaped;
+    for (char character: value) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        }
+        escaped += character;
+    }
+    return escaped;
+}
+
+void writeStatistics(std::ostream &output, const char *name, const FrameStatistics &statistics) {
+    output << "  \"" << name << "\": {\"mean\": " << statistics.mean << ", \"p50\": " << statistics.p50
+           << ", \"p95\": " << statistics.p95 << ", \"p99\": " << statistics.p99 << ", \"max\": " << statistics.max
+           << "}";
+}
+
+bool FrameBenchmark::writeJson(const string &filePath, const string &sceneName, const string &backendName) {
+    collectGpuTimes();
+    FrameStatistics cpu = calculateStatistics(cpuMillis);
+    FrameStatistics gpu = calculateStatistics(gpuMillis);
+    FrameStatistics draws = calculateStatistics(drawCalls);
+
+    auto renderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+
+    std::stringstream json;
+    json << "{\n";
+    json << "  \"scene\": \"" << escapeJson(sceneName) << "\",\n";
+    json << "  \"backend\": \"" << backendName << "\",\n";
+    json << "  \"renderer\": \"" << escapeJson(renderer ? renderer : "") << "\",\n";
+    json << "  \"warmupFrames\": " << warmupFrames << ",\n";
+    json << "  \"measuredFrames\": " << cpuMillis.size() << ",\n";
+    writeStatistics(json, "cpuFrameMs", cpu);
+    json << ",\n";
+    if (gpuMillis.empty()) {
+        json << "  \"gpuFrameMs\": null";
+    } else {
+        writeStatistics(json, "gpuFrameMs", gpu);
+    }
+    json << ",\n";
+    writeStatistics(json, "drawCalls", draws);
+    json << "\n}\n";
+
+    cout << sceneName << ": " << cpuMillis.size() << " frames, CPU p50 " << cpu.p50 << " ms, p95 " << cpu.p95
+         << " ms, p99 " << cpu.p99 << " ms";
+    if (!gpuMillis.empty()) {
+        cout << ", GPU p50 " << gpu.p50 << " ms, p95 " << gpu.p95 << " ms, p99 " << gpu.p99 << " ms";
+    }
+    cout << ", " << draws.p50 << " draws" << endl;
+
+    ofstream file(filePath);
+    if (!file.is_open()) {
+        cout << "Failed to write benchmark results! Path: " << filePath << endl;
+        return false;
+    }
+    file << json.str();
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct FrameStatistics {
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+// Measures a scene frame by frame: CPU time between frame boundaries, GPU time from one GL_TIME_ELAPSED query
+// per frame, and draw calls counted by GlState. Warm-up frames are run but not recorded. Every measured frame
+// gets its own query, and results are only read in writeJson(), so measuring never waits on the GPU.
+class FrameBenchmark {
+public:
+    FrameBenchmark(int warmupFrames, int measuredFrames);
+
+    ~FrameBenchmark();
+
+    FrameBenchmark(const FrameBenchmark &) = delete;
+
+    FrameBenchmark &operator=(const FrameBenchmark &) = delete;
+
+    // Called right before the frame is presented
+    void endFrame();
+
+    // Called right after the frame is presented, which is where the next frame starts
+    void beginFrame();
+
+    bool isDone() const;
+
+    int getTotalFrames() const;
+
+    // Waits for outstanding GPU results, prints a summary and writes it as JSON. Returns false if the file
+    // could not be written.
+    bool writeJson(const std::string &filePath, const std::string &sceneName, const std::string &backendName);
+
+private:
+    int warmupFrames;
+    int measuredFrames;
+    int frameIndex;
+    bool isQueryActive;
+    std::chrono::steady_clock::time_point frameStart;
+    uint64_t frameStartDraws;
+
+    std::vector<unsigned int> queries;
+    std::vector<double> cpuMillis;
+    std::vector<double> gpuMillis;
+    std::vector<double> drawCalls;
+
+    bool isMeasuring() const;
+
+    void collectGpuTimes();
+
+    static FrameStatistics calculateStatistics(std::vector<double> samples);
+};
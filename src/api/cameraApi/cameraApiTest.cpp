@@ -1,14 +1,15 @@
 #include <iostream>
 #include <cameraApi.h>
+#include <contextApi.h>
 #include <shaderApi.h>
-#include <texturesApi.h>
+#include <glStateApi.h>
+#include <textureCache.h>
+#include <meshApi.h>
 #include <stb_image.h>
 #include <glm/gtc/type_ptr.hpp>
 
 using namespace std;
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title);
-
 string getTitle();
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
@@ -38,16 +39,16 @@ const string VERTEX_SHADER = R"glsl(
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+layout (location = 3) in mat4 instanceModel;
 
 out vec2 TexCoord;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main()
 {
-	gl_Position = projection * view * model * vec4(aPos, 1.0f);
+	gl_Position = projection * view * instanceModel * vec4(aPos, 1.0f);
 	TexCoord = vec2(aTexCoord.x, aTexCoord.y);
 }
 )glsl";
@@ -67,23 +68,21 @@ void main()
 }
 )glsl";
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, SCR_WIDTH, SCR_HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(SCR_WIDTH, SCR_HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
 
-    if (glewInit() != GLEW_OK) {
-        return -1;
+        // Сообщаем GLFW, чтобы он захватил наш курсор
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-
-    // Сообщаем GLFW, чтобы он захватил наш курсор
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     // Конфигурирование глобального состояния OpenGL
     glEnable(GL_DEPTH_TEST);
@@ -91,7 +90,7 @@ int main() {
     // Компилирование нашей шейдерной программы
 
     unsigned int shaderProgram = ShaderUtils::CreateShader(VERTEX_SHADER, FRAGMENT_SHADER);
-    glUseProgram(shaderProgram);
+    GlState::useProgram(shaderProgram);
 
     // Указание вершин (и буфера(ов)) и настройка вершинных атрибутов
     float vertices[] = {
@@ -157,9 +156,9 @@ int main() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
 
-    glBindVertexArray(VAO);
+    GlState::bindVertexArray(VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
     // Координатные атрибуты
@@ -171,11 +170,10 @@ int main() {
 
 
     // Загрузка и создание текстур
-    unsigned int texture1, texture2;
-
     // Текстура №1 - Деревянный ящик
-    glGenTextures(1, &texture1);
-    glBindTexture(GL_TEXTURE_2D, texture1);
+    TextureHandle texture1 = TextureCache::load(
+            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/container.jpg", 3);
+    GlState::bindTexture(0, GL_TEXTURE_2D, texture1->getTexture());
 
     // Установка параметров наложения текстуры
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -185,12 +183,10 @@ int main() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-
-    bindTextureRGB("/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/container.jpg");
-
     // Текстура №2 - Смайлик
-    glGenTextures(1, &texture2);
-    glBindTexture(GL_TEXTURE_2D, texture2);
+    TextureHandle texture2 = TextureCache::load(
+            "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/awesomeface.png", 4);
+    GlState::bindTexture(0, GL_TEXTURE_2D, texture2->getTexture());
 
     // Установка параметров наложения текстуры
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -200,8 +196,6 @@ int main() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    bindTextureRGB("/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/awesomeface.png");
-
     // Указываем OpenGL, какой сэмплер к какому текстурному блоку принадлежит (это нужно сделать единожды)
     int texture1UniformLocation = glGetUniformLocation(shaderProgram, "texture1");
     glUniform1i(texture1UniformLocation, 0);
@@ -211,27 +205,38 @@ int main() {
 
     int projectionLocation = glGetUniformLocation(shaderProgram, "projection");
     int viewLocation = glGetUniformLocation(shaderProgram, "view");
-    int modelLocation = glGetUniformLocation(shaderProgram, "model");
+
+    // Ящики неподвижны, поэтому матрицы моделей загружаются в буфер экземпляров один раз
+    InstancedMesh cubes(VAO, 36);
+    vector<glm::mat4> models(10);
+    for (unsigned int i = 0; i < 10; i++) {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, cubePositions[i]);
+        float angle = 20.0f * i;
+        model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+        models[i] = model;
+    }
+    cubes.setTransforms(models);
 
     // Цикл рендеринга
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         // Логическая часть работы со временем для каждого кадра
-        float currentFrame = glfwGetTime();
+        float currentFrame = context.getTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
         // Обработка ввода
-        processInput(window);
+        if (window) {
+            processInput(window);
+        }
 
         // Рендеринг
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // очищаем буфер цвета и буфер глубины
 
         // Привязка текстур к соответствующим текстурным юнитам
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture1);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, texture2);
+        GlState::bindTexture(0, GL_TEXTURE_2D, texture1->getTexture());
+        GlState::bindTexture(1, GL_TEXTURE_2D, texture2->getTexture());
 
         // Передаем шейдеру матрицу проекции (поскольку проекционная матрица редко меняется, то нет необходимости делать это для каждого кадра)
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float) SCR_WIDTH / (float) SCR_HEIGHT, 0.1f,
@@ -242,30 +247,17 @@ int main() {
         glm::mat4 view = camera.GetViewMatrix();
         glUniformMatrix4fv(viewLocation, 1, GL_FALSE, glm::value_ptr(view));
 
-        // Рендерим ящик
-        glBindVertexArray(VAO);
-        for (unsigned int i = 0; i < 10; i++) {
-            // Вычисляем матрицу модели для каждого объекта и передаем её в шейдер до отрисовки
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, cubePositions[i]);
-            float angle = 20.0f * i;
-            model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
-
-            glDrawArrays(GL_TRIANGLES, 0, 36);
-        }
+        // Рендерим все ящики одним вызовом
+        cubes.draw();
 
         // glfw: обмен содержимым front- и back- буферов. Отслеживание событий ввода/вывода (была ли нажата/отпущена кнопка, перемещен курсор мыши и т.п.)
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     // Опционально: освобождаем все ресурсы, как только они выполнили свое предназначение
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
 
-    // glfw: завершение, освобождение всех выделенных ранее GLFW-реcурсов
-    glfwTerminate();
     return 0;
 }
 
@@ -313,16 +305,6 @@ void scroll_callback(GLFWwindow *window, double xoffset, double yoffset) {
     camera.ProcessMouseScroll(yoffset);
 }
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 string getTitle() {
     string title = "Cube";
 
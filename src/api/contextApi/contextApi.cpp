@@ -0,0 +1,366 @@
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+
+#include "contextApi.h"
+#include "benchmarkApi.h"
+#include "profilerApi.h"
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <stb_image_write.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#ifdef GRAPHICS_LABS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+using namespace std;
+
+string getEnvironmentVariable(const char *name) {
+    const char *value = getenv(name);
+    return value ? value : "";
+}
+
+bool startsWith(const string &value, const string &prefix) {
+    return value.compare(0, prefix.size(), prefix) == 0;
+}
+
+RenderContext::RenderContext(int argc, char *argv[], int width, int height, const string &title, bool coreProfile)
+        : backend(ContextBackend::Window), title(title), width(width), height(height), frameLimit(0),
+          frameCount(0), warmupFrames(0), created(false), window(nullptr), eglDisplay(nullptr), eglContext(nullptr), framebuffer(0),
+          colorRenderbuffer(0), depthRenderbuffer(0) {
+    parseOptions(argc, argv);
+
+    bool hasContext = isHeadless() ? createEglContext(coreProfile) : createWindow(coreProfile);
+    if (!hasContext) {
+        return;
+    }
+
+    // GLEW built for GLX reports a missing X display after loading every entry point; that is expected here
+    GLenum glewError = glewInit();
+    if (glewError != GLEW_OK && !(isHeadless() && glewError == GLEW_ERROR_NO_GLX_DISPLAY)) {
+        cout << "Failed to initialize GLEW!" << endl;
+        return;
+    }
+
+    created = !isHeadless() || createFramebuffer();
+    if (!created) {
+        return;
+    }
+
+    if (!tracePath.empty()) {
+        Profiler::start();
+        Profiler::beginFrame();
+    }
+    if (benchmarkPath.empty()) {
+        return;
+    }
+
+    // Vsync would only measure the display's refresh rate
+    if (window) {
+        glfwSwapInterval(0);
+    }
+    benchmark = make_unique<FrameBenchmark>(warmupFrames, frameLimit - warmupFrames);
+    benchmark->beginFrame();
+}
+
+RenderContext::~RenderContext() {
+    saveTrace();
+    saveBenchmark();
+    if (isHeadless()) {
+        destroyEglContext();
+    } else {
+        glfwTerminate();
+    }
+}
+
+void RenderContext::parseOptions(int argc, char *argv[]) {
+    string backendName = getEnvironmentVariable("GRAPHICS_LABS_CONTEXT");
+    string frames = getEnvironmentVariable("GRAPHICS_LABS_FRAMES");
+    capturePath = getEnvironmentVariable("GRAPHICS_LABS_CAPTURE");
+    benchmarkPath = getEnvironmentVariable("GRAPHICS_LABS_BENCHMARK");
+    string warmup = getEnvironmentVariable("GRAPHICS_LABS_WARMUP");
+    tracePath = getEnvironmentVariable("GRAPHICS_LABS_TRACE");
+
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--headless") {
+            backendName = "egl";
+        } else if (startsWith(argument, "--context=")) {
+            backendName = argument.substr(10);
+        } else if (startsWith(argument, "--frames=")) {
+            frames = argument.substr(9);
+        } else if (startsWith(argument, "--capture=")) {
+            capturePath = argument.substr(10);
+        } else if (startsWith(argument, "--benchmark=")) {
+            benchmarkPath = argument.substr(12);
+        } else if (startsWith(argument, "--warmup=")) {
+            warmup = argument.substr(9);
+        } else if (startsWith(argument, "--trace=")) {
+            tracePath = argument.substr(8);
+        }
+    }
+
+    if (backendName == "egl") {
+        backend = ContextBackend::Egl;
+    } else if (!backendName.empty() && backendName != "window") {
+        cout << "Unknown context backend, opening a window instead: " << backendName << endl;
+    }
+
+    if (!benchmarkPath.empty()) {
+        // Benchmarked frames come on top of the warm-up, which covers shader compiles and first uploads
+        warmupFrames = warmup.empty() ? DEFAULT_WARMUP_FRAMES : max(atoi(warmup.c_str()), 0);
+        int measuredFrames = frames.empty() ? DEFAULT_BENCHMARK_FRAMES : max(atoi(frames.c_str()), 1);
+        frameLimit = warmupFrames + measuredFrames;
+        return;
+    }
+
+    // A headless run never gets a close request, so it has to stop on its own
+    frameLimit = frames.empty() ? (isHeadless() ? 1 : 0) : atoi(frames.c_str());
+}
+
+bool RenderContext::createWindow(bool coreProfile) {
+    if (!glfwInit()) {
+        cout << "Failed to initialize GLFW!" << endl;
+        return false;
+    }
+
+    if (coreProfile) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    }
+
+    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
+    if (!window) {
+        cout << "Failed to create GLFW window!" << endl;
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+    return true;
+}
+
+#ifdef GRAPHICS_LABS_EGL
+
+bool RenderContext::createEglContext(bool coreProfile) {
+    // The surfaceless platform needs neither X11 nor a render node; fall back to the default display otherwise
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    EGLDisplay display = EGL_NO_DISPLAY;
+    if (getPlatformDisplay) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        cout << "Failed to initialize EGL!" << endl;
+        return false;
+    }
+    eglDisplay = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        cout << "EGL does not support desktop OpenGL!" << endl;
+        return false;
+    }
+
+    // No surface is ever created, so any surface type will do
+    const EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, 0,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        cout << "Failed to choose an EGL config!" << endl;
+        return false;
+    }
+
+    const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK,
+            coreProfile ? EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT : EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+            EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT) {
+        cout << "Failed to create an EGL context!" << endl;
+        return false;
+    }
+    eglContext = context;
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        cout << "Failed to make the EGL context current!" << endl;
+        return false;
+    }
+    return true;
+}
+
+void RenderContext::destroyEglContext() {
+    if (framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorRenderbuffer);
+        glDeleteRenderbuffers(1, &depthRenderbuffer);
+    }
+    if (eglDisplay) {
+        eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (eglContext) {
+            eglDestroyContext(eglDisplay, eglContext);
+        }
+        eglTerminate(eglDisplay);
+    }
+}
+
+#else
+
+bool RenderContext::createEglContext(bool coreProfile) {
+    cout << "This build has no EGL support, rebuild with EGL development files installed!" << endl;
+    return false;
+}
+
+void RenderContext::destroyEglContext() {
+}
+
+#endif
+
+// A surfaceless context has no default framebuffer, so everything is drawn into this one instead.
+// Demos never bind framebuffer 0, so it stays bound for the whole run.
+bool RenderContext::createFramebuffer() {
+    glGenRenderbuffers(1, &colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        cout << "Offscreen framebuffer is incomplete!" << endl;
+        return false;
+    }
+
+    // Without a surface the initial viewport is empty
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+bool RenderContext::isCreated() const {
+    return created;
+}
+
+bool RenderContext::isHeadless() const {
+    return backend != ContextBackend::Window;
+}
+
+ContextBackend RenderContext::getBackend() const {
+    return backend;
+}
+
+GLFWwindow *RenderContext::getWindow() const {
+    return window;
+}
+
+bool RenderContext::shouldClose() const {
+    if (frameLimit > 0 && frameCount >= frameLimit) {
+        return true;
+    }
+    return window && glfwWindowShouldClose(window);
+}
+
+void RenderContext::swapBuffers() {
+    frameCount++;
+    bool isLastFrame = frameCount == frameLimit || (window && glfwWindowShouldClose(window));
+    if (!capturePath.empty() && isLastFrame) {
+        saveCapture();
+    }
+
+    Profiler::endFrame();
+    if (benchmark) {
+        benchmark->endFrame();
+    }
+
+    if (window) {
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    } else {
+        // Nothing presents a headless frame, so wait for it here to keep per-frame timings honest
+        glFinish();
+    }
+
+    if (benchmark) {
+        benchmark->beginFrame();
+    }
+    // No scope for a frame that is never going to be rendered
+    if (!shouldClose()) {
+        Profiler::beginFrame();
+    }
+}
+
+double RenderContext::getTime() const {
+    if (window) {
+        return glfwGetTime();
+    }
+    return static_cast<double>(frameCount) / HEADLESS_FRAMES_PER_SECOND;
+}
+
+int RenderContext::getFrameCount() const {
+    return frameCount;
+}
+
+int RenderContext::getWidth() const {
+    return width;
+}
+
+int RenderContext::getHeight() const {
+    return height;
+}
+
+// Runs while the context is still alive, also when the window was closed before the last measured frame
+void RenderContext::saveBenchmark() {
+    if (!benchmark) {
+        return;
+    }
+    benchmark->writeJson(benchmarkPath, title, isHeadless() ? "egl" : "window");
+    benchmark.reset();
+}
+
+void RenderContext::saveTrace() {
+    if (tracePath.empty() || !created) {
+        return;
+    }
+    Profiler::writeChromeTrace(tracePath, title);
+    tracePath.clear();
+}
+
+// Saves the frame that is about to be presented as a PNG, top row first
+void RenderContext::saveCapture() const {
+    int captureWidth = width;
+    int captureHeight = height;
+    if (window) {
+        glfwGetFramebufferSize(window, &captureWidth, &captureHeight);
+        glReadBuffer(GL_BACK);
+    } else {
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+    }
+
+    vector<unsigned char> pixels(static_cast<size_t>(captureWidth) * captureHeight * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, captureWidth, captureHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    stbi_flip_vertically_on_write(1);
+    if (stbi_write_png(capturePath.c_str(), captureWidth, captureHeight, 4, pixels.data(), captureWidth * 4)) {
+        cout << "Saved frame " << frameCount << " to " << capturePath << endl;
+    } else {
+        cout << "Failed to save frame! Path: " << capturePath << endl;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+struct GLFWwindow;
+
+class FrameBenchmark;
+
+enum class ContextBackend {
+    Window,
+    Egl
+};
+
+// Owns the GL context of a demo. The backend comes from the command line or, failing that, the environment:
+//   --context=window|egl   or   GRAPHICS_LABS_CONTEXT   (--headless is short for --context=egl)
+//   --frames=N             or   GRAPHICS_LABS_FRAMES    (stop after N frames; headless default is 1)
+//   --capture=frame.png    or   GRAPHICS_LABS_CAPTURE   (save the last frame)
+//   --benchmark=out.json   or   GRAPHICS_LABS_BENCHMARK (write frame timings; --frames then defaults to 300)
+//   --warmup=N             or   GRAPHICS_LABS_WARMUP    (unmeasured frames before those, default 30)
+//   --trace=trace.json     or   GRAPHICS_LABS_TRACE     (profile CPU and GPU scopes as a Chrome trace)
+// The egl backend needs no display or GPU: it makes a surfaceless context (Mesa llvmpipe on CI boxes) and
+// renders into an offscreen framebuffer. Headless time advances by exactly 1/60 s per frame, so every run
+// renders the same images.
+class RenderContext {
+public:
+    static const int HEADLESS_FRAMES_PER_SECOND = 60;
+    static const int DEFAULT_BENCHMARK_FRAMES = 300;
+    static const int DEFAULT_WARMUP_FRAMES = 30;
+
+    // Unknown arguments are left for the demo itself. A core profile is only requested when asked for;
+    // several demos draw without a vertex array object and need the compatibility profile.
+    RenderContext(int argc, char *argv[], int width, int height, const std::string &title,
+                  bool coreProfile = false);
+
+    ~RenderContext();
+
+    RenderContext(const RenderContext &) = delete;
+
+    RenderContext &operator=(const RenderContext &) = delete;
+
+    // False when neither GL nor GLEW could be initialized; the demo should exit
+    bool isCreated() const;
+
+    bool isHeadless() const;
+
+    ContextBackend getBackend() const;
+
+    // nullptr for headless backends, so input and window callbacks have to be skipped
+    GLFWwindow *getWindow() const;
+
+    bool shouldClose() const;
+
+    // Ends the frame: saves the capture after the last one, then swaps and polls events.
+    // When benchmarking or tracing, this is also where frames are timed.
+    void swapBuffers();
+
+    // Replacement for glfwGetTime() that also works without a window
+    double getTime() const;
+
+    int getFrameCount() const;
+
+    int getWidth() const;
+
+    int getHeight() const;
+
+private:
+    ContextBackend backend;
+    std::string title;
+    int width;
+    int height;
+    int frameLimit;
+    int frameCount;
+    std::string capturePath;
+    std::string benchmarkPath;
+    int warmupFrames;
+    std::string tracePath;
+    bool created;
+
+    GLFWwindow *window;
+
+    void *eglDisplay;
+    void *eglContext;
+    unsigned int framebuffer;
+    unsigned int colorRenderbuffer;
+    unsigned int depthRenderbuffer;
+
+    std::unique_ptr<FrameBenchmark> benchmark;
+
+    void parseOptions(int argc, char *argv[]);
+
+    bool createWindow(bool coreProfile);
+
+    bool createEglContext(bool coreProfile);
+
+    bool createFramebuffer();
+
+    void destroyEglContext();
+
+    void saveCapture() const;
+
+    void saveBenchmark();
+
+    void saveTrace();
+};
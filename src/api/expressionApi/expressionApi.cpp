@@ -0,0 +1,558 @@
+#include "expressionApi.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+using namespace std;
+
+const pair<const char *, float> NAMED_CONSTANTS[] = {
+        {"pi", 3.14159265358979f},
+        {"e",  2.71828182845905f}
+};
+
+class Expression::Parser {
+public:
+    explicit Parser(Expression &expression) : expression(expression), text(expression.source), position(0),
+                                              depth(0) {
+    }
+
+    void parse() {
+        parseSum();
+        skipSpaces();
+        if (!hasFailed() && position < text.size()) {
+            fail(string("Unexpected '") + text[position] + "'");
+        }
+        if (!hasFailed() && expression.instructions.empty()) {
+            fail("Empty formula");
+        }
+    }
+
+private:
+    Expression &expression;
+    const string &text;
+    size_t position;
+    int depth;
+
+    bool hasFailed() const {
+        return !expression.error.empty();
+    }
+
+    void fail(const string &message) {
+        if (!hasFailed()) {
+            expression.error = message + " at position " + to_string(position + 1) + " in \"" + text + "\"";
+        }
+    }
+
+    void skipSpaces() {
+        while (position < text.size() && isspace(static_cast<unsigned char>(text[position]))) {
+            position++;
+        }
+    }
+
+    bool accept(char character) {
+        skipSpaces();
+        if (position < text.size() && text[position] == character) {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char character) {
+        if (!hasFailed() && !accept(character)) {
+            fail(string("Expected '") + character + "'");
+        }
+    }
+
+    // sum := product (('+' | '-') product)*
+    void parseSum() {
+        parseProduct();
+        while (!hasFailed()) {
+            if (accept('+')) {
+                parseProduct();
+                emit(OpCode::Add);
+            } else if (accept('-')) {
+                parseProduct();
+                emit(OpCode::Subtract);
+            } else {
+                break;
+            }
+        }
+    }
+
+    // product := unary (('*' | '/') unary)*
+    void parseProduct() {
+        parseUnary();
+        while (!hasFailed()) {
+            if (accept('*')) {
+                parseUnary();
+                emit(OpCode::Multiply);
+            } else if (accept('/')) {
+                parseUnary();
+                emit(OpCode::Divide);
+            } else {
+                break;
+            }
+        }
+    }
+
+    // unary := ('-' | '+') unary | power, so -x^2 is -(x^2)
+    void parseUnary() {
+        if (accept('-')) {
+            parseUnary();
+            emit(OpCode::Negate);
+        } else if (accept('+')) {
+            parseUnary();
+        } else {
+            parsePower();
+        }
+    }
+
+    // power := primary ('^' unary)?, which makes ^ right-associative
+    void parsePower() {
+        parsePrimary();
+        if (!hasFailed() && accept('^')) {
+            parseUnary();
+            emit(OpCode::Power);
+        }
+    }
+
+    void parsePrimary() {
+        if (hasFailed()) {
+            return;
+        }
+        skipSpaces();
+        if (position >= text.size()) {
+            fail("Unexpected end of formula");
+            return;
+        }
+
+        char character = text[position];
+        if (isdigit(static_cast<unsigned char>(character)) || character == '.') {
+            char *end = nullptr;
+            float value = strtof(text.c_str() + position, &end);
+            if (end == text.c_str() + position) {
+                fail("Invalid number");
+                return;
+            }
+            position = end - text.c_str();
+            emitConstant(value);
+            return;
+        }
+
+        if (accept('(')) {
+            parseSum();
+            expect(')');
+            return;
+        }
+
+        if (!isalpha(static_cast<unsigned char>(character))) {
+            fail(string("Unexpected '") + character + "'");
+            return;
+        }
+
+        size_t nameStart = position;
+        while (position < text.size() &&
+               (isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_')) {
+            position++;
+        }
+        string name = text.substr(nameStart, position - nameStart);
+        parseName(name, nameStart);
+    }
+
+    void parseName(const string &name, size_t nameStart) {
+        if (name == "x" || name == "y") {
+            emit(name == "x" ? OpCode::LoadX : OpCode::LoadY);
+            return;
+        }
+        for (const auto &constant: NAMED_CONSTANTS) {
+            if (name == constant.first) {
+                emitConstant(constant.second);
+                return;
+            }
+        }
+
+        for (const Function &function: getFunctions()) {
+            if (name != function.name) {
+                continue;
+            }
+            expect('(');
+            parseSum();
+            for (int argument = 1; argument < function.argumentCount; argument++) {
+                expect(',');
+                parseSum();
+            }
+            expect(')');
+            emit(function.opCode);
+            return;
+        }
+
+        position = nameStart;
+        fail("Unknown name '" + name + "'");
+    }
+
+    void emitConstant(float value) {
+        expression.instructions.push_back({OpCode::LoadConstant, static_cast<int>(expression.constants.size())});
+        expression.constants.push_back(value);
+        depth++;
+        expression.stackDepth = max(expression.stackDepth, depth);
+    }
+
+    static int getArgumentCount(OpCode opCode) {
+        switch (opCode) {
+            case OpCode::LoadX:
+            case OpCode::LoadY:
+            case OpCode::LoadConstant:
+                return 0;
+            case OpCode::Add:
+            case OpCode::Subtract:
+            case OpCode::Multiply:
+            case OpCode::Divide:
+            case OpCode::Power:
+            case OpCode::Min:
+            case OpCode::Max:
+                return 2;
+            default:
+                return 1;
+        }
+    }
+
+    bool isConstantLoad(size_t fromEnd) const {
+        const vector<Instruction> &instructions = expression.instructions;
+        return instructions.size() >= fromEnd &&
+               instructions[instructions.size() - fromEnd].opCode == OpCode::LoadConstant;
+    }
+
+    void emit(OpCode opCode) {
+        if (hasFailed()) {
+            return;
+        }
+
+        int argumentCount = getArgumentCount(opCode);
+        vector<Instruction> &instructions = expression.instructions;
+        vector<float> &constants = expression.constants;
+
+        // Every constant load appends its own constant, so the operands are the last entries of both lists
+        bool isConstantFold = argumentCount > 0 && isConstantLoad(1) && (argumentCount == 1 || isConstantLoad(2));
+        if (isConstantFold) {
+            Expression folded;
+            folded.constants.assign(constants.end() - argumentCount, constants.end());
+            for (int argument = 0; argument < argumentCount; argument++) {
+                folded.instructions.push_back({OpCode::LoadConstant, argument});
+            }
+            folded.instructions.push_back({opCode, 0});
+            folded.stackDepth = argumentCount;
+            float value = folded.evaluate(0.0f);
+
+            instructions.resize(instructions.size() - argumentCount);
+            constants.resize(constants.size() - argumentCount);
+            depth -= argumentCount;
+            emitConstant(value);
+            return;
+        }
+
+        // A literal exponent of 2 or 3 becomes a multiplication
+        if (opCode == OpCode::Power && isConstantLoad(1)) {
+            float exponent = constants.back();
+            if (exponent == 2.0f || exponent == 3.0f) {
+                instructions.pop_back();
+                constants.pop_back();
+                depth--;
+                instructions.push_back({exponent == 2.0f ? OpCode::Square : OpCode::Cube, 0});
+                return;
+            }
+        }
+
+        instructions.push_back({opCode, 0});
+        depth += argumentCount == 0 ? 1 : 1 - argumentCount;
+        expression.stackDepth = max(expression.stackDepth, depth);
+    }
+};
+
+Expression::Expression() : stackDepth(0) {
+}
+
+const vector<Expression::Function> &Expression::getFunctions() {
+    static const vector<Function> functions = {
+            {"sin",   1, OpCode::Sin},
+            {"cos",   1, OpCode::Cos},
+            {"tan",   1, OpCode::Tan},
+            {"asin",  1, OpCode::Asin},
+            {"acos",  1, OpCode::Acos},
+            {"atan",  1, OpCode::Atan},
+            {"sqrt",  1, OpCode::Sqrt},
+            {"abs",   1, OpCode::Abs},
+            {"exp",   1, OpCode::Exp},
+            {"log",   1, OpCode::Log},
+            {"floor", 1, OpCode::Floor},
+            {"ceil",  1, OpCode::Ceil},
+            {"min",   2, OpCode::Min},
+            {"max",   2, OpCode::Max},
+            {"pow",   2, OpCode::Power}
+    };
+    return functions;
+}
+
+Expression Expression::parse(const string &source) {
+    Expression expression;
+    expression.source = source;
+    Parser(expression).parse();
+    if (!expression.error.empty()) {
+        expression.instructions.clear();
+        expression.constants.clear();
+        expression.stackDepth = 0;
+    }
+    return expression;
+}
+
+bool Expression::isValid() const {
+    return error.empty() && !instructions.empty();
+}
+
+const string &Expression::getError() const {
+    return error;
+}
+
+const string &Expression::getSource() const {
+    return source;
+}
+
+float Expression::evaluate(float x, float y) const {
+    float result = 0.0f;
+    evaluate(&x, &y, &result, 1);
+    return result;
+}
+
+void Expression::evaluate(const float *x, const float *y, float *result, size_t count) const {
+    if (!isValid()) {
+        fill(result, result + count, 0.0f);
+        return;
+    }
+
+    // Scratch space is sized by the deepest point of the stack, not by the number of samples
+    vector<const float *> stack(stackDepth);
+    vector<float> registers(static_cast<size_t>(stackDepth) * BATCH_SIZE);
+    vector<float> constantBatches(constants.size() * BATCH_SIZE);
+    for (size_t i = 0; i < constants.size(); i++) {
+        fill_n(constantBatches.begin() + static_cast<long>(i * BATCH_SIZE), BATCH_SIZE, constants[i]);
+    }
+    vector<float> zeros;
+    if (!y) {
+        zeros.assign(BATCH_SIZE, 0.0f);
+    }
+
+    for (size_t offset = 0; offset < count; offset += BATCH_SIZE) {
+        int batchCount = static_cast<int>(min<size_t>(BATCH_SIZE, count - offset));
+        evaluateBatch(x + offset, y ? y + offset : zeros.data(), result + offset, batchCount, stack.data(),
+                      registers.data(), constantBatches.data());
+    }
+}
+
+// GLSL float literals need a decimal point, and there are none for infinity or NaN
+string formatGlslFloat(float value) {
+    if (isnan(value)) {
+        return "(0.0 / 0.0)";
+    }
+    if (isinf(value)) {
+        return value > 0 ? "(1.0 / 0.0)" : "(-1.0 / 0.0)";
+    }
+
+    ostringstream literal;
+    literal << setprecision(9) << value;
+    string text = literal.str();
+    if (text.find_first_of(".e") == string::npos) {
+        text += ".0";
+    }
+    return value < 0 ? "(" + text + ")" : text;
+}
+
+string Expression::toGlsl() const {
+    if (!isValid()) {
+        return "0.0";
+    }
+
+    vector<string> stack;
+    for (const Instruction &instruction: instructions) {
+        switch (instruction.opCode) {
+            case OpCode::LoadX:
+                stack.emplace_back("x");
+                continue;
+            case OpCode::LoadY:
+                stack.emplace_back("y");
+                continue;
+            case OpCode::LoadConstant:
+                stack.push_back(formatGlslFloat(constants[instruction.operand]));
+                continue;
+            case OpCode::Negate:
+                stack.back() = "(-" + stack.back() + ")";
+                continue;
+            case OpCode::Square:
+                stack.back() = "(" + stack.back() + " * " + stack.back() + ")";
+                continue;
+            case OpCode::Cube:
+                stack.back() = "(" + stack.back() + " * " + stack.back() + " * " + stack.back() + ")";
+                continue;
+            default:
+                break;
+        }
+
+        const char *symbol = nullptr;
+        switch (instruction.opCode) {
+            case OpCode::Add:
+                symbol = " + ";
+                break;
+            case OpCode::Subtract:
+                symbol = " - ";
+                break;
+            case OpCode::Multiply:
+                symbol = " * ";
+                break;
+            case OpCode::Divide:
+                symbol = " / ";
+                break;
+            default:
+                break;
+        }
+        if (symbol) {
+            string second = stack.back();
+            stack.pop_back();
+            stack.back() = "(" + stack.back() + symbol + second + ")";
+            continue;
+        }
+
+        for (const Function &function: getFunctions()) {
+            if (function.opCode != instruction.opCode) {
+                continue;
+            }
+            string arguments = stack.back();
+            stack.pop_back();
+            if (function.argumentCount == 2) {
+                arguments = stack.back() + ", " + arguments;
+                stack.pop_back();
+            }
+            stack.push_back(string(function.name) + "(" + arguments + ")");
+            break;
+        }
+    }
+    return stack.back();
+}
+
+template<typename Operation>
+void applyUnary(const float *value, float *result, int count, Operation operation) {
+    for (int i = 0; i < count; i++) {
+        result[i] = operation(value[i]);
+    }
+}
+
+template<typename Operation>
+void applyBinary(const float *first, const float *second, float *result, int count, Operation operation) {
+    for (int i = 0; i < count; i++) {
+        result[i] = operation(first[i], second[i]);
+    }
+}
+
+// Stack slot i holds a pointer to the inputs, a constant batch, or registers row i, where results are written
+void Expression::evaluateBatch(const float *x, const float *y, float *result, int count, const float **stack,
+                               float *registers, const float *constantBatches) const {
+    int top = -1;
+    for (const Instruction &instruction: instructions) {
+        if (instruction.opCode == OpCode::LoadX) {
+            stack[++top] = x;
+            continue;
+        }
+        if (instruction.opCode == OpCode::LoadY) {
+            stack[++top] = y;
+            continue;
+        }
+        if (instruction.opCode == OpCode::LoadConstant) {
+            stack[++top] = constantBatches + static_cast<size_t>(instruction.operand) * BATCH_SIZE;
+            continue;
+        }
+
+        const float *first = stack[top];
+        float *output = registers + static_cast<size_t>(top) * BATCH_SIZE;
+        switch (instruction.opCode) {
+            case OpCode::Negate:
+                applyUnary(first, output, count, [](float value) { return -value; });
+                break;
+            case OpCode::Square:
+                applyUnary(first, output, count, [](float value) { return value * value; });
+                break;
+            case OpCode::Cube:
+                applyUnary(first, output, count, [](float value) { return value * value * value; });
+                break;
+            case OpCode::Sin:
+                applyUnary(first, output, count, [](float value) { return sin(value); });
+                break;
+            case OpCode::Cos:
+                applyUnary(first, output, count, [](float value) { return cos(value); });
+                break;
+            case OpCode::Tan:
+                applyUnary(first, output, count, [](float value) { return tan(value); });
+                break;
+            case OpCode::Asin:
+                applyUnary(first, output, count, [](float value) { return asin(value); });
+                break;
+            case OpCode::Acos:
+                applyUnary(first, output, count, [](float value) { return acos(value); });
+                break;
+            case OpCode::Atan:
+                applyUnary(first, output, count, [](float value) { return atan(value); });
+                break;
+            case OpCode::Sqrt:
+                applyUnary(first, output, count, [](float value) { return sqrt(value); });
+                break;
+            case OpCode::Abs:
+                applyUnary(first, output, count, [](float value) { return abs(value); });
+                break;
+            case OpCode::Exp:
+                applyUnary(first, output, count, [](float value) { return exp(value); });
+                break;
+            case OpCode::Log:
+                applyUnary(first, output, count, [](float value) { return log(value); });
+                break;
+            case OpCode::Floor:
+                applyUnary(first, output, count, [](float value) { return floor(value); });
+                break;
+            case OpCode::Ceil:
+                applyUnary(first, output, count, [](float value) { return ceil(value); });
+                break;
+            default: {
+                // Binary: the result replaces the first operand, one slot down
+                const float *second = first;
+                first = stack[--top];
+                output = registers + static_cast<size_t>(top) * BATCH_SIZE;
+                switch (instruction.opCode) {
+                    case OpCode::Add:
+                        applyBinary(first, second, output, count, [](float a, float b) { return a + b; });
+                        break;
+                    case OpCode::Subtract:
+                        applyBinary(first, second, output, count, [](float a, float b) { return a - b; });
+                        break;
+                    case OpCode::Multiply:
+                        applyBinary(first, second, output, count, [](float a, float b) { return a * b; });
+                        break;
+                    case OpCode::Divide:
+                        applyBinary(first, second, output, count, [](float a, float b) { return a / b; });
+                        break;
+                    case OpCode::Power:
+                        applyBinary(first, second, output, count, [](float a, float b) { return pow(a, b); });
+                        break;
+                    case OpCode::Min:
+                        applyBinary(first, second, output, count, [](float a, float b) { return b < a ? b : a; });
+                        break;
+                    default:
+                        applyBinary(first, second, output, count, [](float a, float b) { return a < b ? b : a; });
+                        break;
+                }
+            }
+        }
+        stack[top] = output;
+    }
+
+    copy(stack[0], stack[0] + count, result);
+}
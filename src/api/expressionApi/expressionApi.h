@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// A formula in x and y, parsed once into stack bytecode, e.g. "x^3 - 2*x", "sin(x) * cos(y)" or
+// "sqrt(max(x, 0)) + sqrt(max(y, 0))". Supports + - * / ^, unary minus, parentheses, the constants pi and e,
+// sin cos tan asin acos atan sqrt abs exp log floor ceil, and the two-argument min max pow.
+// Evaluation runs each instruction over a whole batch of samples before the next one, so the interpreter
+// costs one dispatch per instruction and batch, and the loops in between are plain array arithmetic.
+class Expression {
+public:
+    static const int BATCH_SIZE = 256;
+
+    // Never throws; check isValid() and show getError() to whoever typed the formula
+    static Expression parse(const std::string &source);
+
+    bool isValid() const;
+
+    const std::string &getError() const;
+
+    const std::string &getSource() const;
+
+    float evaluate(float x, float y = 0.0f) const;
+
+    // y may be nullptr when the formula only uses x; it then reads as 0. Invalid expressions produce zeros.
+    void evaluate(const float *x, const float *y, float *result, size_t count) const;
+
+    // The same formula as a GLSL float expression of x and y, for evaluating it in a shader instead.
+    // GLSL leaves pow() undefined for a negative base, so only ^2 and ^3 are safe there for negative values.
+    std::string toGlsl() const;
+
+private:
+    enum class OpCode {
+        LoadX,
+        LoadY,
+        LoadConstant,
+        Negate,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Power,
+        // x^2 and x^3 with a literal exponent, which would otherwise go through powf
+        Square,
+        Cube,
+        Min,
+        Max,
+        Sin,
+        Cos,
+        Tan,
+        Asin,
+        Acos,
+        Atan,
+        Sqrt,
+        Abs,
+        Exp,
+        Log,
+        Floor,
+        Ceil
+    };
+
+    // Named the same in GLSL, which toGlsl() relies on
+    struct Function {
+        const char *name;
+        int argumentCount;
+        OpCode opCode;
+    };
+
+    struct Instruction {
+        OpCode opCode;
+        // Index into constants for LoadConstant
+        int operand;
+    };
+
+    std::string source;
+    std::string error;
+    std::vector<Instruction> instructions;
+    std::vector<float> constants;
+    int stackDepth;
+
+    class Parser;
+
+    Expression();
+
+    static const std::vector<Function> &getFunctions();
+
+    void evaluateBatch(const float *x, const float *y, float *result, int count, const float **stack,
+                       float *registers, const float *constantBatches) const;
+};
@@ -0,0 +1,194 @@
+#include "glStateApi.h"
+#include <GL/glew.h>
+
+// fill() takes it by reference, so it needs a definition outside the class
+const unsigned int GlState::UNKNOWN;
+
+GlState::State::State() {
+    textures2D.fill(UNKNOWN);
+    capabilities.fill(UNKNOWN);
+}
+
+GlState::State &GlState::getState() {
+    static State state;
+    return state;
+}
+
+// Stores the value and reports whether the GL call has to be issued
+bool GlState::update(unsigned int &cached, unsigned int value) {
+    GlStateCounters &counters = getState().counters;
+    if (cached == value) {
+        counters.skipped++;
+        return false;
+    }
+    cached = value;
+    counters.issued++;
+    return true;
+}
+
+unsigned int *GlState::getBufferSlot(unsigned int target) {
+    State &state = getState();
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            return &state.arrayBuffer;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return &state.elementArrayBuffer;
+        case GL_UNIFORM_BUFFER:
+            return &state.uniformBuffer;
+        default:
+            return nullptr;
+    }
+}
+
+unsigned int *GlState::getCapabilitySlot(unsigned int capability) {
+    State &state = getState();
+    switch (capability) {
+        case GL_DEPTH_TEST:
+            return &state.capabilities[0];
+        case GL_BLEND:
+            return &state.capabilities[1];
+        case GL_CULL_FACE:
+            return &state.capabilities[2];
+        case GL_PRIMITIVE_RESTART:
+            return &state.capabilities[3];
+        default:
+            return nullptr;
+    }
+}
+
+void GlState::useProgram(unsigned int program) {
+    if (update(getState().program, program)) {
+        glUseProgram(program);
+    }
+}
+
+unsigned int GlState::getProgram() {
+    return getState().program;
+}
+
+void GlState::bindVertexArray(unsigned int vertexArray) {
+    State &state = getState();
+    if (update(state.vertexArray, vertexArray)) {
+        glBindVertexArray(vertexArray);
+        // The element array binding is part of the vertex array object
+        state.elementArrayBuffer = UNKNOWN;
+    }
+}
+
+void GlState::bindBuffer(unsigned int target, unsigned int buffer) {
+    unsigned int *slot = getBufferSlot(target);
+    if (!slot) {
+        getState().counters.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (update(*slot, buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void GlState::activeTexture(unsigned int unit) {
+    if (update(getState().activeTextureUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void GlState::bindTexture(unsigned int unit, unsigned int target, unsigned int texture) {
+    State &state = getState();
+    // Callers follow up with glTexImage2D and friends, so the unit is made active even when the bind is skipped
+    activeTexture(unit);
+    if (target == GL_TEXTURE_2D && unit < TEXTURE_UNITS) {
+        if (state.textures2D[unit] == texture) {
+            state.counters.skipped++;
+            return;
+        }
+        state.textures2D[unit] = texture;
+    }
+
+    state.counters.issued++;
+    glBindTexture(target, texture);
+}
+
+void GlState::polygonMode(unsigned int mode) {
+    if (update(getState().polygonMode, mode)) {
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+}
+
+void GlState::setEnabled(unsigned int capability, bool enabled) {
+    unsigned int *slot = getCapabilitySlot(capability);
+    if (slot && !update(*slot, enabled ? 1 : 0)) {
+        return;
+    }
+    if (!slot) {
+        getState().counters.issued++;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void GlState::drawArrays(unsigned int mode, int first, int count) {
+    getState().counters.draws++;
+    glDrawArrays(mode, first, count);
+}
+
+void GlState::drawArraysInstanced(unsigned int mode, int first, int count, int instanceCount) {
+    getState().counters.draws++;
+    glDrawArraysInstanced(mode, first, count, instanceCount);
+}
+
+void GlState::drawElements(unsigned int mode, int count, unsigned int type, const void *indices) {
+    getState().counters.draws++;
+    glDrawElements(mode, count, type, indices);
+}
+
+void GlState::onProgramDeleted(unsigned int program) {
+    State &state = getState();
+    if (state.program == program) {
+        state.program = UNKNOWN;
+    }
+}
+
+void GlState::onVertexArrayDeleted(unsigned int vertexArray) {
+    State &state = getState();
+    if (state.vertexArray == vertexArray) {
+        state.vertexArray = UNKNOWN;
+        state.elementArrayBuffer = UNKNOWN;
+    }
+}
+
+void GlState::onBufferDeleted(unsigned int buffer) {
+    State &state = getState();
+    for (unsigned int *slot: {&state.arrayBuffer, &state.elementArrayBuffer, &state.uniformBuffer}) {
+        if (*slot == buffer) {
+            *slot = UNKNOWN;
+        }
+    }
+}
+
+void GlState::onTextureDeleted(unsigned int texture) {
+    for (unsigned int &boundTexture: getState().textures2D) {
+        if (boundTexture == texture) {
+            boundTexture = UNKNOWN;
+        }
+    }
+}
+
+void GlState::invalidate() {
+    State &state = getState();
+    GlStateCounters counters = state.counters;
+    state = State();
+    state.counters = counters;
+}
+
+GlStateCounters GlState::getCounters() {
+    return getState().counters;
+}
+
+void GlState::resetCounters() {
+    getState().counters = {0, 0, 0};
+}
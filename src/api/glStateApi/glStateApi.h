@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+struct GlStateCounters {
+    uint64_t issued;
+    uint64_t skipped;
+    uint64_t draws;
+};
+
+// Shadow copy of the GL binding and raster state. Each call is forwarded to GL only when it would change the
+// current state. Everything starts out unknown, so the first call of each kind always goes through.
+// Code that binds state behind the tracker's back has to call invalidate() afterwards.
+class GlState {
+public:
+    static void useProgram(unsigned int program);
+
+    // The program last made current through useProgram(), or UNKNOWN after invalidate()
+    static unsigned int getProgram();
+
+    static void bindVertexArray(unsigned int vertexArray);
+
+    static void bindBuffer(unsigned int target, unsigned int buffer);
+
+    static void activeTexture(unsigned int unit);
+
+    static void bindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+
+    static void polygonMode(unsigned int mode);
+
+    static void setEnabled(unsigned int capability, bool enabled);
+
+    // Draw calls are never skipped; they only go through here to be counted
+    static void drawArrays(unsigned int mode, int first, int count);
+
+    static void drawArraysInstanced(unsigned int mode, int first, int count, int instanceCount);
+
+    static void drawElements(unsigned int mode, int count, unsigned int type, const void *indices);
+
+    // Deleted names may be reused by GL, so they must not stay cached
+    static void onProgramDeleted(unsigned int program);
+
+    static void onVertexArrayDeleted(unsigned int vertexArray);
+
+    static void onBufferDeleted(unsigned int buffer);
+
+    static void onTextureDeleted(unsigned int texture);
+
+    static void invalidate();
+
+    static GlStateCounters getCounters();
+
+    static void resetCounters();
+
+private:
+    static const unsigned int UNKNOWN = 0xFFFFFFFF;
+    static const int TEXTURE_UNITS = 32;
+    static const int CAPABILITIES = 4;
+
+    struct State {
+        unsigned int program = UNKNOWN;
+        unsigned int vertexArray = UNKNOWN;
+        unsigned int arrayBuffer = UNKNOWN;
+        unsigned int elementArrayBuffer = UNKNOWN;
+        unsigned int uniformBuffer = UNKNOWN;
+        unsigned int activeTextureUnit = UNKNOWN;
+        std::array<unsigned int, TEXTURE_UNITS> textures2D;
+        unsigned int polygonMode = UNKNOWN;
+        // GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE, GL_PRIMITIVE_RESTART: 0 off, 1 on, UNKNOWN
+        std::array<unsigned int, CAPABILITIES> capabilities;
+        GlStateCounters counters{0, 0, 0};
+
+        State();
+    };
+
+    static State &getState();
+
+    static bool update(unsigned int &cached, unsigned int value);
+
+    static unsigned int *getBufferSlot(unsigned int target);
+
+    static unsigned int *getCapabilitySlot(unsigned int capability);
+};
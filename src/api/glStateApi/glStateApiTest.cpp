@@ -0,0 +1,73 @@
+#include <GL/glew.h>
+#include "glStateApi.h"
+#include "contextApi.h"
+#include <iostream>
+
+using namespace std;
+
+bool expect(bool condition, const string &message) {
+    if (!condition) {
+        cout << "FAILED: " << message << endl;
+    }
+    return condition;
+}
+
+int getActiveUnit() {
+    int activeTexture = 0;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    return activeTexture - GL_TEXTURE0;
+}
+
+// A skipped texture bind still has to leave its unit active, since callers upload into it right after
+bool testSkippedBindActivatesUnit() {
+    unsigned int textures[2];
+    glGenTextures(2, textures);
+    GlState::invalidate();
+    GlState::resetCounters();
+
+    GlState::bindTexture(0, GL_TEXTURE_2D, textures[0]);
+    GlState::bindTexture(1, GL_TEXTURE_2D, textures[1]);
+    GlState::bindTexture(0, GL_TEXTURE_2D, textures[0]);
+    GlStateCounters counters = GlState::getCounters();
+
+    int boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+    bool passed = expect(getActiveUnit() == 0, "unit 0 is active after binding (0, A), (1, B), (0, A)") &&
+                  expect(static_cast<unsigned int>(boundTexture) == textures[0], "A is bound on unit 0") &&
+                  expect(counters.skipped == 1, "the second bind of A is skipped");
+
+    glDeleteTextures(2, textures);
+    GlState::onTextureDeleted(textures[0]);
+    GlState::onTextureDeleted(textures[1]);
+    return passed;
+}
+
+bool testRepeatedBindsAreSkipped() {
+    unsigned int vertexArray;
+    glGenVertexArrays(1, &vertexArray);
+    GlState::invalidate();
+    GlState::resetCounters();
+
+    GlState::bindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
+    GlStateCounters counters = GlState::getCounters();
+    bool passed = expect(counters.issued == 1 && counters.skipped == 1, "a repeated vertex array bind is skipped");
+
+    GlState::bindVertexArray(0);
+    glDeleteVertexArrays(1, &vertexArray);
+    GlState::onVertexArrayDeleted(vertexArray);
+    return passed;
+}
+
+// Needs a GL context but draws nothing, so it is usually run with --headless
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, 64, 64, "GL State Test");
+    if (!context.isCreated()) {
+        return -1;
+    }
+
+    bool passed = testSkippedBindActivatesUnit();
+    passed = testRepeatedBindsAreSkipped() && passed;
+    cout << (passed ? "All GL state checks passed" : "Some GL state checks failed") << endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,268 @@
+#include "chunkedSurface.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+const string VERTEX_SHADER_HEAD = R"glsl(
+#version 330 core
+
+layout(location = 0) in vec2 gridPosition;
+
+out vec3 color;
+
+uniform vec2 chunkOrigin;
+uniform float chunkSize;
+uniform int cellsPerChunk;
+// Cells of this chunk per cell of the neighbor on the -x, +x, -z and +z edge; 1 unless the neighbor is coarser
+uniform vec4 edgeStrides;
+uniform vec3 surfaceColor;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+float height(float x, float y) {
+    return )glsl";
+
+const string VERTEX_SHADER_TAIL = R"glsl(;
+}
+
+vec2 getPosition(ivec2 index) {
+    return chunkOrigin + vec2(index) * (chunkSize / float(cellsPerChunk));
+}
+
+float getHeight(ivec2 index) {
+    vec2 position = getPosition(index);
+    return height(position.x, position.y);
+}
+
+void main() {
+    ivec2 index = ivec2(round(gridPosition * float(cellsPerChunk)));
+
+    ivec2 direction = ivec2(0);
+    int stride = 1;
+    if (index.x == 0 || index.x == cellsPerChunk) {
+        direction = ivec2(0, 1);
+        stride = int(index.x == 0 ? edgeStrides.x : edgeStrides.y);
+    } else if (index.y == 0 || index.y == cellsPerChunk) {
+        direction = ivec2(1, 0);
+        stride = int(index.y == 0 ? edgeStrides.z : edgeStrides.w);
+    }
+
+    // A vertex between two of the coarser neighbor's vertices goes onto the line between them
+    int offset = (index.x * direction.x + index.y * direction.y) % stride;
+    float y = getHeight(index);
+    if (offset != 0) {
+        ivec2 low = index - direction * offset;
+        y = mix(getHeight(low), getHeight(low + direction * stride), float(offset) / float(stride));
+    }
+
+    vec2 position = getPosition(index);
+    gl_Position = projection * view * model * vec4(position.x, y, position.y, 1.0);
+    color = surfaceColor;
+}
+)glsl";
+
+const string FRAGMENT_SHADER = R"glsl(
+#version 330 core
+
+in vec3 color;
+
+out vec4 fragmentColor;
+
+void main() {
+    fragmentColor = vec4(color, 1.0);
+}
+)glsl";
+
+// Keeps getKey() within its 20 bits per coordinate
+const int MAX_LEVEL = 20;
+
+ChunkedSurface::ChunkedSurface(const Expression &inputExpression, float inputStart, float inputEnd,
+                               float minCellSize, const glm::vec3 &inputColor)
+        : expression(inputExpression),
+          program(ShaderProgram::createShaderProgramFromStrings(
+                  VERTEX_SHADER_HEAD + inputExpression.toGlsl() + VERTEX_SHADER_TAIL, FRAGMENT_SHADER)),
+          unitGrid(UnitGrid::getShared(CELLS_PER_CHUNK)), start(inputStart), size(inputEnd - inputStart),
+          maxLevel(0), lodDistance(2.0f), color(inputColor), stats{0, 0, 0}, localViewer(0.0f) {
+    float rootCellSize = size / static_cast<float>(CELLS_PER_CHUNK);
+    while (maxLevel < MAX_LEVEL && rootCellSize / static_cast<float>(1 << maxLevel) > minCellSize) {
+        maxLevel++;
+    }
+}
+
+void ChunkedSurface::setLodDistance(float distance) {
+    lodDistance = distance;
+}
+
+uint64_t ChunkedSurface::getKey(const Chunk &chunk) {
+    return static_cast<uint64_t>(chunk.level) << 40 | static_cast<uint64_t>(chunk.x) << 20 |
+           static_cast<uint64_t>(chunk.z);
+}
+
+float ChunkedSurface::getChunkSize(int level) const {
+    return size / static_cast<float>(1 << level);
+}
+
+// Over the chunk's own vertices, which also bound the ones moved onto a coarser neighbor's edge
+const ChunkedSurface::Bounds &ChunkedSurface::getBounds(const Chunk &chunk) {
+    auto found = bounds.find(getKey(chunk));
+    if (found != bounds.end()) {
+        return found->second;
+    }
+
+    float chunkSize = getChunkSize(chunk.level);
+    float cellSize = chunkSize / static_cast<float>(CELLS_PER_CHUNK);
+    float x0 = start + static_cast<float>(chunk.x) * chunkSize;
+    float z0 = start + static_cast<float>(chunk.z) * chunkSize;
+
+    int side = CELLS_PER_CHUNK + 1;
+    vector<float> xValues(side);
+    vector<float> zValues(side);
+    vector<float> heights(side);
+    for (int j = 0; j < side; j++) {
+        zValues[j] = z0 + static_cast<float>(j) * cellSize;
+    }
+
+    // fmin and fmax skip NaN, which the shader would not draw either
+    float minHeight = NAN;
+    float maxHeight = NAN;
+    for (int i = 0; i < side; i++) {
+        fill(xValues.begin(), xValues.end(), x0 + static_cast<float>(i) * cellSize);
+        expression.evaluate(xValues.data(), zValues.data(), heights.data(), side);
+        for (float height: heights) {
+            minHeight = fmin(minHeight, height);
+            maxHeight = fmax(maxHeight, height);
+        }
+    }
+    if (isnan(minHeight)) {
+        minHeight = 0.0f;
+        maxHeight = 0.0f;
+    }
+
+    Bounds chunkBounds{glm::vec3(x0, minHeight, z0), glm::vec3(x0 + chunkSize, maxHeight, z0 + chunkSize)};
+    return bounds.emplace(getKey(chunk), chunkBounds).first->second;
+}
+
+bool ChunkedSurface::shouldSplit(const Chunk &chunk) {
+    if (chunk.level >= maxLevel) {
+        return false;
+    }
+
+    const Bounds &chunkBounds = getBounds(chunk);
+    glm::vec3 closest = glm::min(glm::max(localViewer, chunkBounds.min), chunkBounds.max);
+    return glm::distance(localViewer, closest) < lodDistance * getChunkSize(chunk.level);
+}
+
+// A box is outside when all its corners are behind one plane; boxes near a frustum corner may still pass
+bool ChunkedSurface::isInFrustum(const Bounds &chunkBounds) const {
+    for (const glm::vec4 &plane: frustumPlanes) {
+        glm::vec4 farthest(plane.x > 0.0f ? chunkBounds.max.x : chunkBounds.min.x,
+                           plane.y > 0.0f ? chunkBounds.max.y : chunkBounds.min.y,
+                           plane.z > 0.0f ? chunkBounds.max.z : chunkBounds.min.z, 1.0f);
+        if (glm::dot(plane, farthest) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ChunkedSurface::selectChunks(const Chunk &chunk) {
+    if (!isInFrustum(getBounds(chunk))) {
+        stats.culledChunks++;
+        return;
+    }
+
+    if (!shouldSplit(chunk)) {
+        visibleChunks.push_back(chunk);
+        return;
+    }
+
+    for (int child = 0; child < 4; child++) {
+        selectChunks({chunk.level + 1, chunk.x * 2 + child % 2, chunk.z * 2 + child / 2});
+    }
+}
+
+// Independent of culling, so a chunk also stitches to neighbors that are not drawn
+int ChunkedSurface::getLevelAt(float x, float z) {
+    Chunk chunk{0, 0, 0};
+    while (shouldSplit(chunk)) {
+        float childSize = getChunkSize(chunk.level + 1);
+        int childX = static_cast<int>((x - start) / childSize);
+        int childZ = static_cast<int>((z - start) / childSize);
+        chunk = {chunk.level + 1, clamp(childX, chunk.x * 2, chunk.x * 2 + 1),
+                 clamp(childZ, chunk.z * 2, chunk.z * 2 + 1)};
+    }
+    return chunk.level;
+}
+
+// (x, z) is just across the edge, halfway along it
+int ChunkedSurface::getEdgeStride(const Chunk &chunk, float x, float z) {
+    if (x < start || z < start || x > start + size || z > start + size) {
+        return 1;
+    }
+
+    int levelDifference = chunk.level - getLevelAt(x, z);
+    if (levelDifference <= 0) {
+        return 1;
+    }
+    return min(1 << levelDifference, static_cast<int>(CELLS_PER_CHUNK));
+}
+
+void ChunkedSurface::draw(const glm::mat4 &model, const glm::mat4 &view, const glm::mat4 &projection,
+                          const glm::vec3 &viewerPosition) {
+    glm::vec4 viewer = glm::inverse(model) * glm::vec4(viewerPosition, 1.0f);
+    localViewer = glm::vec3(viewer.x, viewer.y, viewer.z);
+
+    // Planes of the frustum in the surface's own space, as rows of the clip matrix
+    glm::mat4 clip = projection * view * model;
+    for (int plane = 0; plane < 6; plane++) {
+        int row = plane / 2;
+        float sign = plane % 2 == 0 ? 1.0f : -1.0f;
+        for (int column = 0; column < 4; column++) {
+            frustumPlanes[plane][column] = clip[column][3] + sign * clip[column][row];
+        }
+    }
+
+    stats = {0, 0, 0};
+    visibleChunks.clear();
+    selectChunks({0, 0, 0});
+
+    program.use();
+    program.setInt("cellsPerChunk"_u, CELLS_PER_CHUNK);
+    program.setVec3("surfaceColor"_u, color);
+    program.setMat4("model"_u, model);
+    program.setMat4("view"_u, view);
+    program.setMat4("projection"_u, projection);
+
+    // Far enough across an edge to land in the neighbor even at the finest level
+    float across = getChunkSize(maxLevel) / static_cast<float>(2 * CELLS_PER_CHUNK);
+    for (const Chunk &chunk: visibleChunks) {
+        float chunkSize = getChunkSize(chunk.level);
+        float x0 = start + static_cast<float>(chunk.x) * chunkSize;
+        float z0 = start + static_cast<float>(chunk.z) * chunkSize;
+        float xMiddle = x0 + chunkSize / 2.0f;
+        float zMiddle = z0 + chunkSize / 2.0f;
+
+        program.setVec2("chunkOrigin"_u, x0, z0);
+        program.setFloat("chunkSize"_u, chunkSize);
+        program.setVec4("edgeStrides"_u,
+                        static_cast<float>(getEdgeStride(chunk, x0 - across, zMiddle)),
+                        static_cast<float>(getEdgeStride(chunk, x0 + chunkSize + across, zMiddle)),
+                        static_cast<float>(getEdgeStride(chunk, xMiddle, z0 - across)),
+                        static_cast<float>(getEdgeStride(chunk, xMiddle, z0 + chunkSize + across)));
+        unitGrid->draw();
+    }
+
+    stats.chunks = static_cast<int>(visibleChunks.size());
+    stats.triangles = stats.chunks * unitGrid->getIndexCount() / 3;
+}
+
+ChunkedSurfaceStats ChunkedSurface::getStats() const {
+    return stats;
+}
+
+int ChunkedSurface::getLevelCount() const {
+    return maxLevel + 1;
+}
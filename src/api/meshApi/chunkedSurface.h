@@ -0,0 +1,88 @@
+#pragma once
+
+#include "gpuHeightField.h"
+#include "expressionApi.h"
+#include "shaderApi.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+struct ChunkedSurfaceStats {
+    int chunks;
+    int culledChunks;
+    int triangles;
+};
+
+// y = f(x, z) over a large square, split into a quadtree of chunks. Every frame the chunks near the viewer are
+// split until their distance is at least lodDistance chunk sizes, down to cells of minCellSize; the rest stay
+// coarse, so the drawn triangle count grows with the number of levels rather than with the domain's area.
+// Every chunk is the same shared unit grid with its height computed in the vertex shader. Along an edge shared
+// with a coarser chunk the vertices that chunk does not have are put on its straight edge, so nothing cracks.
+// Chunks outside the view frustum are skipped, using height bounds evaluated on the CPU once per chunk.
+class ChunkedSurface {
+public:
+    static const int CELLS_PER_CHUNK = 32;
+
+    // The expression must be valid; it is evaluated on the CPU for the bounds and as GLSL for the vertices
+    ChunkedSurface(const Expression &inputExpression, float inputStart, float inputEnd, float minCellSize,
+                   const glm::vec3 &inputColor);
+
+    ChunkedSurface(const ChunkedSurface &) = delete;
+
+    ChunkedSurface &operator=(const ChunkedSurface &) = delete;
+
+    void setLodDistance(float distance);
+
+    // viewerPosition is in world space, usually Camera::Position. Leaves the surface's program in use.
+    void draw(const glm::mat4 &model, const glm::mat4 &view, const glm::mat4 &projection,
+              const glm::vec3 &viewerPosition);
+
+    ChunkedSurfaceStats getStats() const;
+
+    int getLevelCount() const;
+
+private:
+    struct Chunk {
+        int level;
+        int x;
+        int z;
+    };
+
+    struct Bounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    Expression expression;
+    ShaderProgram program;
+    std::shared_ptr<UnitGrid> unitGrid;
+    float start;
+    float size;
+    int maxLevel;
+    float lodDistance;
+    glm::vec3 color;
+    // Keyed by getKey(); grows with the part of the domain that has been looked at closely
+    std::unordered_map<uint64_t, Bounds> bounds;
+    std::vector<Chunk> visibleChunks;
+    ChunkedSurfaceStats stats;
+    glm::vec3 localViewer;
+    glm::vec4 frustumPlanes[6];
+
+    static uint64_t getKey(const Chunk &chunk);
+
+    float getChunkSize(int level) const;
+
+    const Bounds &getBounds(const Chunk &chunk);
+
+    bool shouldSplit(const Chunk &chunk);
+
+    bool isInFrustum(const Bounds &chunkBounds) const;
+
+    void selectChunks(const Chunk &chunk);
+
+    int getLevelAt(float x, float z);
+
+    int getEdgeStride(const Chunk &chunk, float x, float z);
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+// Eight floats that go through arithmetic together. Built with AVX (GRAPHICS_LABS_AVX2 in CMake) it is a
+// single __m256 register; otherwise it is a plain array whose loops the compiler vectorizes for its target.
+// min and max return the second argument when either is NaN, like the AVX instructions do.
+// Everything is inline, since a call per operation would cost more than the operation.
+class FloatLanes {
+public:
+    static const int SIZE = 8;
+
+    static FloatLanes broadcast(float value);
+
+    static FloatLanes load(const float *values);
+
+    void store(float *values) const;
+
+    static FloatLanes sqrt(const FloatLanes &lanes);
+
+    static FloatLanes min(const FloatLanes &first, const FloatLanes &second);
+
+    static FloatLanes max(const FloatLanes &first, const FloatLanes &second);
+
+    FloatLanes operator+(const FloatLanes &other) const;
+
+    FloatLanes operator-(const FloatLanes &other) const;
+
+    FloatLanes operator*(const FloatLanes &other) const;
+
+    FloatLanes operator/(const FloatLanes &other) const;
+
+private:
+#ifdef __AVX__
+    __m256 lanes;
+#else
+    float lanes[SIZE];
+#endif
+};
+
+#ifdef __AVX__
+
+inline FloatLanes FloatLanes::broadcast(float value) {
+    FloatLanes result;
+    result.lanes = _mm256_set1_ps(value);
+    return result;
+}
+
+inline FloatLanes FloatLanes::load(const float *values) {
+    FloatLanes result;
+    result.lanes = _mm256_loadu_ps(values);
+    return result;
+}
+
+inline void FloatLanes::store(float *values) const {
+    _mm256_storeu_ps(values, lanes);
+}
+
+inline FloatLanes FloatLanes::sqrt(const FloatLanes &lanes) {
+    FloatLanes result;
+    result.lanes = _mm256_sqrt_ps(lanes.lanes);
+    return result;
+}
+
+inline FloatLanes FloatLanes::min(const FloatLanes &first, const FloatLanes &second) {
+    FloatLanes result;
+    result.lanes = _mm256_min_ps(first.lanes, second.lanes);
+    return result;
+}
+
+inline FloatLanes FloatLanes::max(const FloatLanes &first, const FloatLanes &second) {
+    FloatLanes result;
+    result.lanes = _mm256_max_ps(first.lanes, second.lanes);
+    return result;
+}
+
+inline FloatLanes FloatLanes::operator+(const FloatLanes &other) const {
+    FloatLanes result;
+    result.lanes = _mm256_add_ps(lanes, other.lanes);
+    return result;
+}
+
+inline FloatLanes FloatLanes::operator-(const FloatLanes &other) const {
+    FloatLanes result;
+    result.lanes = _mm256_sub_ps(lanes, other.lanes);
+    return result;
+}
+
+inline FloatLanes FloatLanes::operator*(const FloatLanes &other) const {
+    FloatLanes result;
+    result.lanes = _mm256_mul_ps(lanes, other.lanes);
+    return result;
+}
+
+inline FloatLanes FloatLanes::operator/(const FloatLanes &other) const {
+    FloatLanes result;
+    result.lanes = _mm256_div_ps(lanes, other.lanes);
+    return result;
+}
+
+#else
+
+inline FloatLanes FloatLanes::broadcast(float value) {
+    FloatLanes result;
+    std::fill(result.lanes, result.lanes + SIZE, value);
+    return result;
+}
+
+inline FloatLanes FloatLanes::load(const float *values) {
+    FloatLanes result;
+    std::copy(values, values + SIZE, result.lanes);
+    return result;
+}
+
+inline void FloatLanes::store(float *values) const {
+    std::copy(lanes, lanes + SIZE, values);
+}
+
+inline FloatLanes FloatLanes::sqrt(const FloatLanes &lanes) {
+    FloatLanes result;
+    for (int i = 0; i < SIZE; i++) {
+        result.lanes[i] = std::sqrt(lanes.lanes[i]);
+    }
+    return result;
+}
+
+inline FloatLanes FloatLanes::min(const FloatLanes &first, const FloatLanes &second) {
+    FloatLanes result;
+    for (int i = 0; i < SIZE; i++) {
+        result.lanes[i] = first.lanes[i] < second.lanes[i] ? first.lanes[i] : second.lanes[i];
+    }
+    return result;
+}
+
+inline FloatLanes FloatLanes::max(const FloatLanes &first, const FloatLanes &second) {
+    FloatLanes result;
+    for (int i = 0; i < SIZE; i++) {
+        result.lanes[i] = first.lanes[i] > second.lanes[i] ? first.lanes[i] : second.lanes[i];
+    }
+    return result;
+}
+
+inline FloatLanes FloatLanes::operator+(const FloatLanes &other) const {
+    FloatLanes result;
+    for (int i = 0; i < SIZE; i++) {
+        result.lanes[i] = lanes[i] + other.lanes[i];
+    }
+    return result;
+}
+
+inline FloatLanes FloatLanes::operator-(const FloatLanes &other) const {
+    FloatLanes result;
+    for (int i = 0; i < SIZE; i++) {
+        result.lanes[i] = lanes[i] - other.lanes[i];
+    }
+    return result;
+}
+
+inline FloatLanes FloatLanes::operator*(const FloatLanes &other) const {
+    FloatLanes result;
+    for (int i = 0; i < SIZE; i++) {
+        result.lanes[i] = lanes[i] * other.lanes[i];
+    }
+    return result;
+}
+
+inline FloatLanes FloatLanes::operator/(const FloatLanes &other) const {
+    FloatLanes result;
+    for (int i = 0; i < SIZE; i++) {
+        result.lanes[i] = lanes[i] / other.lanes[i];
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include "gpuHeightField.h"
+#include "glStateApi.h"
+#include <GL/glew.h>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+const string VERTEX_SHADER_HEAD = R"glsl(
+#version 330 core
+
+layout(location = 0) in vec2 gridPosition;
+
+out vec3 color;
+
+uniform vec2 gridStart;
+uniform vec2 gridExtent;
+uniform vec3 surfaceColor;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+float height(float x, float y) {
+    return )glsl";
+
+const string VERTEX_SHADER_TAIL = R"glsl(;
+}
+
+void main() {
+    vec2 position = gridStart + gridPosition * gridExtent;
+    gl_Position = projection * view * model * vec4(position.x, height(position.x, position.y), position.y, 1.0);
+    color = surfaceColor;
+}
+)glsl";
+
+const string FRAGMENT_SHADER = R"glsl(
+#version 330 core
+
+in vec3 color;
+
+out vec4 fragmentColor;
+
+void main() {
+    fragmentColor = vec4(color, 1.0);
+}
+)glsl";
+
+// Vertices are stored row by row like HeightFieldMesher's, so the wireframe matches
+UnitGrid::UnitGrid(int inputCellsPerSide)
+        : vertexArray(0), vertexBuffer(0), elementBuffer(0), cellsPerSide(inputCellsPerSide),
+          indexCount(inputCellsPerSide * inputCellsPerSide * 6) {
+    if (indexCount == 0) {
+        return;
+    }
+
+    int side = cellsPerSide + 1;
+    vector<float> vertices(static_cast<size_t>(side) * side * 2);
+    float *vertex = vertices.data();
+    for (int i = 0; i < side; i++) {
+        for (int j = 0; j < side; j++) {
+            vertex[0] = static_cast<float>(i) / static_cast<float>(cellsPerSide);
+            vertex[1] = static_cast<float>(j) / static_cast<float>(cellsPerSide);
+            vertex += 2;
+        }
+    }
+    vector<unsigned int> indices(indexCount);
+    HeightFieldMesher::writeIndices(indices.data(), side, 0, cellsPerSide);
+
+    glGenVertexArrays(1, &vertexArray);
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &elementBuffer);
+
+    GlState::bindVertexArray(vertexArray);
+
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long>(vertices.size() * sizeof(float)), vertices.data(),
+                 GL_STATIC_DRAW);
+
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long>(indices.size() * sizeof(unsigned int)),
+                 indices.data(), GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+    glEnableVertexAttribArray(0);
+
+    GlState::bindVertexArray(0);
+}
+
+UnitGrid::~UnitGrid() {
+    if (vertexArray == 0) {
+        return;
+    }
+    glDeleteVertexArrays(1, &vertexArray);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &elementBuffer);
+    GlState::onVertexArrayDeleted(vertexArray);
+    GlState::onBufferDeleted(vertexBuffer);
+    GlState::onBufferDeleted(elementBuffer);
+}
+
+// Weak, so a resolution nobody draws anymore frees its buffers
+shared_ptr<UnitGrid> UnitGrid::getShared(int cellsPerSide) {
+    static map<int, weak_ptr<UnitGrid>> unitGrids;
+
+    shared_ptr<UnitGrid> unitGrid = unitGrids[cellsPerSide].lock();
+    if (!unitGrid) {
+        unitGrid = make_shared<UnitGrid>(cellsPerSide);
+        unitGrids[cellsPerSide] = unitGrid;
+    }
+    return unitGrid;
+}
+
+void UnitGrid::draw() const {
+    if (indexCount == 0) {
+        return;
+    }
+    GlState::bindVertexArray(vertexArray);
+    GlState::drawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+}
+
+int UnitGrid::getCellsPerSide() const {
+    return cellsPerSide;
+}
+
+int UnitGrid::getIndexCount() const {
+    return indexCount;
+}
+
+GpuHeightField::GpuHeightField(const string &heightExpression, const HeightFieldGrid &inputGrid,
+                               const glm::vec3 &inputColor)
+        : program(ShaderProgram::createShaderProgramFromStrings(createVertexShader(heightExpression),
+                                                                FRAGMENT_SHADER)),
+          grid(inputGrid), color(inputColor), unitGrid(UnitGrid::getShared(inputGrid.getCellsPerSide())) {}
+
+string GpuHeightField::createVertexShader(const string &heightExpression) {
+    return VERTEX_SHADER_HEAD + heightExpression + VERTEX_SHADER_TAIL;
+}
+
+void GpuHeightField::setGrid(const HeightFieldGrid &newGrid) {
+    if (newGrid.getCellsPerSide() != grid.getCellsPerSide()) {
+        unitGrid = UnitGrid::getShared(newGrid.getCellsPerSide());
+    }
+    grid = newGrid;
+}
+
+void GpuHeightField::draw(const glm::mat4 &model, const glm::mat4 &view, const glm::mat4 &projection) {
+    program.use();
+    // Spans whole cells like the CPU mesher, so the last row sits at start + cells * step
+    float extent = static_cast<float>(grid.getCellsPerSide()) * grid.step;
+    program.setVec2("gridStart"_u, grid.start, grid.start);
+    program.setVec2("gridExtent"_u, extent, extent);
+    program.setVec3("surfaceColor"_u, color);
+    program.setMat4("model"_u, model);
+    program.setMat4("view"_u, view);
+    program.setMat4("projection"_u, projection);
+    unitGrid->draw();
+}
+
+int GpuHeightField::getIndexCount() const {
+    return unitGrid->getIndexCount();
+}
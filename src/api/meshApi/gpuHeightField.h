@@ -0,0 +1,63 @@
+#pragma once
+
+#include "heightFieldMesher.h"
+#include "shaderApi.h"
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+
+// Static index-buffered grid over [0, 1]², the only geometry of the surfaces whose height comes from a shader.
+// One instance per resolution is shared by everything that draws it and lives as long as one of them does.
+class UnitGrid {
+public:
+    explicit UnitGrid(int cellsPerSide);
+
+    ~UnitGrid();
+
+    UnitGrid(const UnitGrid &) = delete;
+
+    UnitGrid &operator=(const UnitGrid &) = delete;
+
+    static std::shared_ptr<UnitGrid> getShared(int cellsPerSide);
+
+    void draw() const;
+
+    int getCellsPerSide() const;
+
+    int getIndexCount() const;
+
+private:
+    unsigned int vertexArray;
+    unsigned int vertexBuffer;
+    unsigned int elementBuffer;
+    int cellsPerSide;
+    int indexCount;
+};
+
+// Draws y = f(x, z) with the height computed in the vertex shader, so nothing is evaluated or uploaded on the
+// CPU per surface. Every surface of the same resolution draws the same static unit grid, which stays alive as
+// long as one of them does; moving the grid's range only changes uniforms.
+class GpuHeightField {
+public:
+    // heightExpression is GLSL in x and y (the grid's z), e.g. "x * x + y * y" or Expression::toGlsl()
+    GpuHeightField(const std::string &heightExpression, const HeightFieldGrid &inputGrid, const glm::vec3 &inputColor);
+
+    GpuHeightField(const GpuHeightField &) = delete;
+
+    GpuHeightField &operator=(const GpuHeightField &) = delete;
+
+    void setGrid(const HeightFieldGrid &newGrid);
+
+    // Leaves the surface's program in use
+    void draw(const glm::mat4 &model, const glm::mat4 &view, const glm::mat4 &projection);
+
+    int getIndexCount() const;
+
+private:
+    ShaderProgram program;
+    HeightFieldGrid grid;
+    glm::vec3 color;
+    std::shared_ptr<UnitGrid> unitGrid;
+
+    static std::string createVertexShader(const std::string &heightExpression);
+};
@@ -0,0 +1,112 @@
+#include "heightFieldMesher.h"
+#include "threadApi.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+const int CELLS_PER_SIDE[] = {1024, 4096};
+// Six floats per vertex and six vertices per cell need 2.4 GB at 4096 cells per side
+const int MAX_SIX_VERTEX_CELLS_PER_SIDE = 1024;
+const int RUNS = 3;
+
+float paraboloid(float x, float y) {
+    return x * x + y * y;
+}
+
+float squareRoots(float x, float y) {
+    return sqrt(max(x, 0.0f)) + sqrt(max(y, 0.0f));
+}
+
+FloatLanes paraboloidLanes(FloatLanes x, FloatLanes y) {
+    return x * x + y * y;
+}
+
+FloatLanes squareRootsLanes(FloatLanes x, FloatLanes y) {
+    FloatLanes zero = FloatLanes::broadcast(0.0f);
+    return FloatLanes::sqrt(FloatLanes::max(x, zero)) + FloatLanes::sqrt(FloatLanes::max(y, zero));
+}
+
+// The loop lab2 used before the mesher: float-accumulated counters, six vertices per cell, no reserve
+vector<float> generateSixVerticesPerCell(float (*func)(float, float), const HeightFieldGrid &grid) {
+    vector<float> positions;
+    for (float x = grid.start; x < grid.end;) {
+        for (float y = grid.start; y < grid.end;) {
+            const float corners[6][2] = {{x, y}, {x, y + grid.step}, {x + grid.step, y + grid.step},
+                                         {x, y}, {x + grid.step, y}, {x + grid.step, y + grid.step}};
+            for (const auto &corner: corners) {
+                positions.push_back(corner[0]);
+                positions.push_back(func(corner[0], corner[1]));
+                positions.push_back(corner[1]);
+                positions.push_back(1.0f);
+                positions.push_back(0.0f);
+                positions.push_back(0.0f);
+            }
+            y += grid.step;
+        }
+        x += grid.step;
+    }
+    return positions;
+}
+
+template<class Generate>
+double measureMillis(Generate generate) {
+    double best = 0.0;
+    for (int run = 0; run < RUNS; run++) {
+        auto start = chrono::steady_clock::now();
+        generate();
+        auto end = chrono::steady_clock::now();
+        double millis = chrono::duration<double, milli>(end - start).count();
+        best = run == 0 ? millis : min(best, millis);
+    }
+    return best;
+}
+
+float getMaxHeightDifference(const HeightFieldMesh &first, const HeightFieldMesh &second) {
+    float difference = 0.0f;
+    for (size_t i = 1; i < first.vertices.size(); i += HeightFieldMesher::FLOATS_PER_VERTEX) {
+        difference = max(difference, abs(first.vertices[i] - second.vertices[i]));
+    }
+    return difference;
+}
+
+template<class LanesFunction>
+void compare(const char *formula, float (*func)(float, float), const LanesFunction &lanesFunction,
+             int cellsPerSide) {
+    HeightFieldGrid grid{-4.0f, 4.0f, 8.0f / static_cast<float>(cellsPerSide)};
+    glm::vec3 color(1.0f, 0.0f, 0.0f);
+
+    cout << formula << ", " << cellsPerSide << "x" << cellsPerSide << " cells:";
+    if (cellsPerSide <= MAX_SIX_VERTEX_CELLS_PER_SIDE) {
+        double sixVertices = measureMillis([&] { generateSixVerticesPerCell(func, grid); });
+        cout << " six vertices per cell " << sixVertices << " ms,";
+    }
+
+    double indexed = measureMillis([&] { HeightFieldMesher::generate(func, grid, color); });
+    double parallel = measureMillis([&] { HeightFieldMesher::generateParallel(lanesFunction, grid, color); });
+    Expression expression = Expression::parse(formula);
+    double parsed = measureMillis([&] { HeightFieldMesher::generateParallel(expression, grid, color); });
+
+    // Lane math may round differently from the scalar function, e.g. when it is contracted into FMA
+    float difference = getMaxHeightDifference(HeightFieldMesher::generate(func, grid, color),
+                                               HeightFieldMesher::generateParallel(lanesFunction, grid, color));
+    cout << " indexed " << indexed << " ms, indexed parallel " << parallel << " ms, parsed formula " << parsed
+         << " ms (max height difference " << difference << ")" << endl;
+}
+
+int main() {
+    cout << "Threads: " << ThreadPool::getShared().getThreadCount() + 1 << ", lanes: " << FloatLanes::SIZE
+#ifdef __AVX__
+         << " (AVX)"
+#endif
+         << endl;
+
+    for (int cellsPerSide: CELLS_PER_SIDE) {
+        compare("x * x + y * y", paraboloid, paraboloidLanes, cellsPerSide);
+        compare("sqrt(max(x, 0)) + sqrt(max(y, 0))", squareRoots, squareRootsLanes, cellsPerSide);
+    }
+
+    return 0;
+}
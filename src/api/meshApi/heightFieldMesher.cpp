@@ -0,0 +1,143 @@
+#include "heightFieldMesher.h"
+#include "glStateApi.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Counted rather than accumulated, so float error in step cannot add or drop a row
+int HeightFieldGrid::getCellsPerSide() const {
+    return max(static_cast<int>(lround((end - start) / step)), 0);
+}
+
+int HeightFieldGrid::getVerticesPerSide() const {
+    return getCellsPerSide() + 1;
+}
+
+HeightFieldMesh HeightFieldMesher::allocateMesh(const HeightFieldGrid &grid) {
+    int cells = grid.getCellsPerSide();
+    int side = grid.getVerticesPerSide();
+
+    HeightFieldMesh mesh;
+    mesh.vertices.resize(static_cast<size_t>(side) * side * FLOATS_PER_VERTEX);
+    mesh.indices.resize(static_cast<size_t>(cells) * cells * 6);
+    return mesh;
+}
+
+HeightFieldMesh HeightFieldMesher::generate(const HeightFunction &function, const HeightFieldGrid &grid,
+                                            const glm::vec3 &color) {
+    int cells = grid.getCellsPerSide();
+    int side = grid.getVerticesPerSide();
+    HeightFieldMesh mesh = allocateMesh(grid);
+
+    float *vertex = mesh.vertices.data();
+    for (int i = 0; i < side; i++) {
+        float x = grid.start + static_cast<float>(i) * grid.step;
+        for (int j = 0; j < side; j++) {
+            float z = grid.start + static_cast<float>(j) * grid.step;
+            writeVertex(vertex, x, function(x, z), z, color);
+            vertex += FLOATS_PER_VERTEX;
+        }
+    }
+
+    writeIndices(mesh.indices.data(), side, 0, cells);
+
+    return mesh;
+}
+
+HeightFieldMesh HeightFieldMesher::generateParallel(const Expression &expression, const HeightFieldGrid &grid,
+                                                    const glm::vec3 &color, ThreadPool &pool) {
+    int cells = grid.getCellsPerSide();
+    int side = grid.getVerticesPerSide();
+    HeightFieldMesh mesh = allocateMesh(grid);
+
+    vector<float> zValues(side);
+    for (int j = 0; j < side; j++) {
+        zValues[j] = grid.start + static_cast<float>(j) * grid.step;
+    }
+
+    pool.parallelFor(side, [&](int beginRow, int endRow) {
+        vector<float> xValues(side);
+        vector<float> heights(side);
+        for (int i = beginRow; i < endRow; i++) {
+            float x = grid.start + static_cast<float>(i) * grid.step;
+            fill(xValues.begin(), xValues.end(), x);
+            expression.evaluate(xValues.data(), zValues.data(), heights.data(), side);
+
+            float *vertex = mesh.vertices.data() + static_cast<size_t>(i) * side * FLOATS_PER_VERTEX;
+            for (int j = 0; j < side; j++) {
+                writeVertex(vertex, x, heights[j], zValues[j], color);
+                vertex += FLOATS_PER_VERTEX;
+            }
+        }
+    });
+
+    pool.parallelFor(cells, [&](int beginRow, int endRow) {
+        writeIndices(mesh.indices.data(), side, beginRow, endRow);
+    });
+
+    return mesh;
+}
+
+// Same two triangles per cell as the old six-vertex generator, so the wireframe looks the same
+void HeightFieldMesher::writeIndices(unsigned int *indices, int verticesPerSide, int beginRow, int endRow) {
+    int cells = verticesPerSide - 1;
+    unsigned int *index = indices + static_cast<size_t>(beginRow) * cells * 6;
+    for (int i = beginRow; i < endRow; i++) {
+        for (int j = 0; j < cells; j++) {
+            auto corner = static_cast<unsigned int>(i * verticesPerSide + j);
+            auto nextRow = corner + static_cast<unsigned int>(verticesPerSide);
+            index[0] = corner;
+            index[1] = corner + 1;
+            index[2] = nextRow + 1;
+            index[3] = corner;
+            index[4] = nextRow;
+            index[5] = nextRow + 1;
+            index += 6;
+        }
+    }
+}
+
+HeightFieldBuffers HeightFieldMesher::upload(const HeightFieldMesh &mesh) {
+    return upload(mesh, chooseFormat(mesh));
+}
+
+VertexFormat HeightFieldMesher::chooseFormat(const HeightFieldMesh &mesh) {
+    for (size_t i = 0; i < mesh.vertices.size(); i += FLOATS_PER_VERTEX) {
+        for (int component = 0; component < 3; component++) {
+            if (fabs(mesh.vertices[i + component]) > HALF_FLOAT_RANGE) {
+                return VertexFormat().add(0, 3).add(1, 3, VertexAttributeType::UnsignedByteNormalized);
+            }
+        }
+    }
+    return VertexFormat::compactPositionColor();
+}
+
+HeightFieldBuffers HeightFieldMesher::upload(const HeightFieldMesh &mesh, const VertexFormat &format) {
+    HeightFieldBuffers buffers{0, 0, 0, static_cast<int>(mesh.indices.size())};
+    if (mesh.indices.empty()) {
+        return buffers;
+    }
+
+    glGenVertexArrays(1, &buffers.vertexArray);
+    glGenBuffers(1, &buffers.vertexBuffer);
+    glGenBuffers(1, &buffers.elementBuffer);
+
+    GlState::bindVertexArray(buffers.vertexArray);
+
+    GlState::bindBuffer(GL_ARRAY_BUFFER, buffers.vertexBuffer);
+    vector<unsigned char> vertices = format.pack(mesh.vertices);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertices.size()), vertices.data(), GL_STATIC_DRAW);
+
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.elementBuffer);
+    unsigned long elementBufferSize = mesh.indices.size() * sizeof(unsigned int);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long> (elementBufferSize), mesh.indices.data(),
+                 GL_STATIC_DRAW);
+
+    format.setAttributePointers();
+
+    GlState::bindVertexArray(0);
+
+    return buffers;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "expressionApi.h"
+#include "floatLanes.h"
+#include "threadApi.h"
+#include "vertexFormat.h"
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Square grid over [start, end] on both x and z with a vertex every step
+struct HeightFieldGrid {
+    float start;
+    float end;
+    float step;
+
+    int getCellsPerSide() const;
+
+    int getVerticesPerSide() const;
+};
+
+struct HeightFieldMesh {
+    // Interleaved position and color, FLOATS_PER_VERTEX per vertex, row by row along z
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+};
+
+struct HeightFieldBuffers {
+    unsigned int vertexArray;
+    unsigned int vertexBuffer;
+    unsigned int elementBuffer;
+    int indexCount;
+};
+
+// Turns y = f(x, z) into an indexed triangle mesh. Each grid vertex is evaluated and stored once and shared
+// through the index buffer by the up to six triangles around it.
+class HeightFieldMesher {
+public:
+    static const int FLOATS_PER_VERTEX = 6;
+    // Half floats are exact to 1/256 below this magnitude, so positions within it may be stored that way
+    static constexpr float HALF_FLOAT_RANGE = 8.0f;
+
+    using HeightFunction = std::function<float(float, float)>;
+
+    static HeightFieldMesh generate(const HeightFunction &function, const HeightFieldGrid &grid,
+                                    const glm::vec3 &color);
+
+    // Same mesh, with rows split across the pool and heights evaluated FloatLanes::SIZE at a time. The function
+    // takes and returns FloatLanes, e.g. [](FloatLanes x, FloatLanes z) { return x * x + z * z; }
+    template<typename LanesFunction>
+    static HeightFieldMesh generateParallel(const LanesFunction &function, const HeightFieldGrid &grid,
+                                            const glm::vec3 &color, ThreadPool &pool = ThreadPool::getShared());
+
+    // For formulas typed in at runtime; each row is evaluated as one batch
+    static HeightFieldMesh generateParallel(const Expression &expression, const HeightFieldGrid &grid,
+                                            const glm::vec3 &color, ThreadPool &pool = ThreadPool::getShared());
+
+    // Position goes to attribute 0 and color to attribute 1; the element buffer stays bound to the vertex array.
+    // Without a format, chooseFormat() picks one for the mesh.
+    static HeightFieldBuffers upload(const HeightFieldMesh &mesh);
+
+    static HeightFieldBuffers upload(const HeightFieldMesh &mesh, const VertexFormat &format);
+
+    // 8-bit colors, and half-float positions only when every coordinate is within HALF_FLOAT_RANGE; surfaces
+    // from user formulas easily go beyond it and keep float positions
+    static VertexFormat chooseFormat(const HeightFieldMesh &mesh);
+
+    // Two triangles per cell for the cell rows [beginRow, endRow) of a grid stored row by row; indices points at
+    // the start of the whole index buffer
+    static void writeIndices(unsigned int *indices, int verticesPerSide, int beginRow, int endRow);
+
+private:
+    static HeightFieldMesh allocateMesh(const HeightFieldGrid &grid);
+
+    static void writeVertex(float *vertex, float x, float y, float z, const glm::vec3 &color);
+};
+
+// Inline, since the parallel path calls it once per vertex from code compiled in the caller's unit
+inline void HeightFieldMesher::writeVertex(float *vertex, float x, float y, float z, const glm::vec3 &color) {
+    vertex[0] = x;
+    vertex[1] = y;
+    vertex[2] = z;
+    vertex[3] = color.x;
+    vertex[4] = color.y;
+    vertex[5] = color.z;
+}
+
+template<typename LanesFunction>
+HeightFieldMesh HeightFieldMesher::generateParallel(const LanesFunction &function, const HeightFieldGrid &grid,
+                                                    const glm::vec3 &color, ThreadPool &pool) {
+    int cells = grid.getCellsPerSide();
+    int side = grid.getVerticesPerSide();
+    HeightFieldMesh mesh = allocateMesh(grid);
+
+    // z is the same for every row; padding it to whole lanes lets the last load stay in bounds
+    int paddedSide = (side + FloatLanes::SIZE - 1) / FloatLanes::SIZE * FloatLanes::SIZE;
+    std::vector<float> zValues(paddedSide);
+    for (int j = 0; j < paddedSide; j++) {
+        zValues[j] = grid.start + static_cast<float>(std::min(j, side - 1)) * grid.step;
+    }
+
+    pool.parallelFor(side, [&](int beginRow, int endRow) {
+        float heights[FloatLanes::SIZE];
+        for (int i = beginRow; i < endRow; i++) {
+            float x = grid.start + static_cast<float>(i) * grid.step;
+            FloatLanes xLanes = FloatLanes::broadcast(x);
+            float *vertex = mesh.vertices.data() + static_cast<size_t>(i) * side * FLOATS_PER_VERTEX;
+
+            for (int j = 0; j < side; j += FloatLanes::SIZE) {
+                function(xLanes, FloatLanes::load(zValues.data() + j)).store(heights);
+                int laneCount = std::min(side - j, static_cast<int>(FloatLanes::SIZE));
+                for (int lane = 0; lane < laneCount; lane++) {
+                    writeVertex(vertex, x, heights[lane], zValues[j + lane], color);
+                    vertex += FLOATS_PER_VERTEX;
+                }
+            }
+        }
+    });
+
+    pool.parallelFor(cells, [&](int beginRow, int endRow) {
+        writeIndices(mesh.indices.data(), side, beginRow, endRow);
+    });
+
+    return mesh;
+}
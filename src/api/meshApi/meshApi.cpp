@@ -0,0 +1,61 @@
+#include "meshApi.h"
+#include "glStateApi.h"
+#include <GL/glew.h>
+
+using namespace std;
+
+InstancedMesh::InstancedMesh(unsigned int inputVertexArray, int inputVertexCount)
+        : vertexArray(inputVertexArray), instanceBuffer(0), vertexCount(inputVertexCount), instanceCount(0),
+          capacity(0) {
+    glGenBuffers(1, &instanceBuffer);
+
+    GlState::bindVertexArray(vertexArray);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+    // A mat4 attribute takes four consecutive locations, one per column
+    auto strideSize = static_cast<int>(sizeof(glm::mat4));
+    for (unsigned int column = 0; column < 4; column++) {
+        unsigned int location = MODEL_ATTRIBUTE_LOCATION + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, strideSize, (void *) (column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+
+    GlState::bindVertexArray(0);
+}
+
+InstancedMesh::~InstancedMesh() {
+    glDeleteBuffers(1, &instanceBuffer);
+    GlState::onBufferDeleted(instanceBuffer);
+}
+
+void InstancedMesh::setTransforms(const vector<glm::mat4> &transforms) {
+    instanceCount = static_cast<int>(transforms.size());
+    if (transforms.empty()) {
+        return;
+    }
+
+    size_t size = transforms.size() * sizeof(glm::mat4);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    if (size > capacity) {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<long> (size), &transforms.front(), GL_STREAM_DRAW);
+        capacity = size;
+    } else {
+        // Orphan the old storage, so the upload does not wait for the previous frame's draw
+        glBufferData(GL_ARRAY_BUFFER, static_cast<long> (capacity), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<long> (size), &transforms.front());
+    }
+}
+
+void InstancedMesh::draw() const {
+    if (instanceCount == 0) {
+        return;
+    }
+
+    GlState::bindVertexArray(vertexArray);
+    GlState::drawArraysInstanced(GL_TRIANGLES, 0, vertexCount, instanceCount);
+}
+
+int InstancedMesh::getInstanceCount() const {
+    return instanceCount;
+}
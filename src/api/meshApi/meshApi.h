@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Draws one mesh many times with a single glDrawArraysInstanced call. The per-instance model matrices live
+// in their own buffer attached to the mesh's vertex array as four vec4 attributes with divisor 1, read in
+// the vertex shader as: layout(location = 3) in mat4 instanceModel;
+class InstancedMesh {
+public:
+    static const unsigned int MODEL_ATTRIBUTE_LOCATION = 3;
+
+    InstancedMesh(unsigned int inputVertexArray, int inputVertexCount);
+
+    ~InstancedMesh();
+
+    InstancedMesh(const InstancedMesh &) = delete;
+
+    InstancedMesh &operator=(const InstancedMesh &) = delete;
+
+    void setTransforms(const std::vector<glm::mat4> &transforms);
+
+    void draw() const;
+
+    int getInstanceCount() const;
+
+private:
+    unsigned int vertexArray;
+    unsigned int instanceBuffer;
+    int vertexCount;
+    int instanceCount;
+    size_t capacity;
+};
@@ -0,0 +1,159 @@
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "contextApi.h"
+#include "shaderApi.h"
+#include "meshApi.h"
+#include "glStateApi.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+using namespace std;
+
+const int FRAMES = 20;
+const size_t CUBE_COUNTS[] = {10, 1000, 10000, 100000};
+
+const string PER_DRAW_VERTEX_SHADER = R"glsl(
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+
+uniform mat4 model;
+uniform mat4 viewProjection;
+
+void main(){
+    gl_Position = viewProjection * model * vec4(aPos, 1.0);
+}
+)glsl";
+
+const string INSTANCED_VERTEX_SHADER = R"glsl(
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 3) in mat4 instanceModel;
+
+uniform mat4 viewProjection;
+
+void main(){
+    gl_Position = viewProjection * instanceModel * vec4(aPos, 1.0);
+}
+)glsl";
+
+const string FRAGMENT_SHADER = R"glsl(
+#version 330 core
+
+out vec4 fragmentColor;
+
+void main() {
+    fragmentColor = vec4(1.0, 0.5, 0.2, 1.0);
+}
+)glsl";
+
+unsigned int generateCubeVertexArray() {
+    vector<float> positions;
+    const float corners[8][3] = {
+            {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+            {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}
+    };
+    const int faces[6][4] = {{0, 1, 2, 3}, {4, 5, 6, 7}, {0, 3, 7, 4}, {1, 2, 6, 5}, {0, 1, 5, 4}, {3, 2, 6, 7}};
+    for (const auto &face: faces) {
+        for (int corner: {0, 1, 2, 2, 3, 0}) {
+            positions.insert(positions.end(), corners[face[corner]], corners[face[corner]] + 3);
+        }
+    }
+
+    unsigned int vertexArray;
+    unsigned int vertexBuffer;
+    glGenVertexArrays(1, &vertexArray);
+    glGenBuffers(1, &vertexBuffer);
+
+    GlState::bindVertexArray(vertexArray);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    unsigned long vertexBufferSize = positions.size() * sizeof(float);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+    glEnableVertexAttribArray(0);
+    GlState::bindVertexArray(0);
+
+    return vertexArray;
+}
+
+// Same spinning grid as "cubes <count>", so both paths pay for the same per-frame matrix math
+void buildTransforms(vector<glm::mat4> &models, float time) {
+    auto side = static_cast<size_t>(ceil(cbrt(static_cast<double>(models.size()))));
+    for (size_t i = 0; i < models.size(); i++) {
+        glm::vec3 position(static_cast<float>(i % side), static_cast<float>(i / side % side),
+                           -static_cast<float>(i / (side * side)));
+        auto model = glm::translate(glm::mat4(1.0f), position * 1.5f);
+        models[i] = glm::rotate(model, time * glm::radians(20.0f), glm::vec3(0.5f, 1.0f, 0.0f));
+    }
+}
+
+template<class Frame>
+double measureMillisPerFrame(Frame frame) {
+    frame(0.0f);
+    glFinish();
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < FRAMES; i++) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        frame(static_cast<float>(i) / FRAMES);
+    }
+    glFinish();
+    auto end = chrono::steady_clock::now();
+    return static_cast<double>(chrono::duration_cast<chrono::microseconds>(end - start).count()) / 1000.0 / FRAMES;
+}
+
+// Run with --headless or LIBGL_ALWAYS_SOFTWARE=1 to measure under Mesa llvmpipe
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, 64, 64, "Mesh Api Benchmark");
+    if (!context.isCreated()) {
+        return -1;
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    unsigned int cubeVertexArray = generateCubeVertexArray();
+
+    glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 200.0f) *
+                               glm::translate(glm::mat4(1.0f), glm::vec3(-35.0f, -35.0f, -60.0f));
+
+    ShaderProgram perDrawProgram = ShaderProgram::createShaderProgramFromStrings(PER_DRAW_VERTEX_SHADER,
+                                                                                 FRAGMENT_SHADER);
+    ShaderProgram instancedProgram = ShaderProgram::createShaderProgramFromStrings(INSTANCED_VERTEX_SHADER,
+                                                                                   FRAGMENT_SHADER);
+    InstancedMesh cubes(cubeVertexArray, 36);
+
+    cout << "Renderer: " << glGetString(GL_RENDERER) << endl;
+    for (size_t cubeCount: CUBE_COUNTS) {
+        vector<glm::mat4> models(cubeCount);
+
+        double perDraw = measureMillisPerFrame([&](float time) {
+            buildTransforms(models, time);
+            perDrawProgram.use();
+            perDrawProgram.setMat4("viewProjection"_u, viewProjection);
+            GlState::bindVertexArray(cubeVertexArray);
+            for (const glm::mat4 &model: models) {
+                perDrawProgram.setMat4("model"_u, model);
+                glDrawArrays(GL_TRIANGLES, 0, 36);
+            }
+        });
+
+        double instanced = measureMillisPerFrame([&](float time) {
+            buildTransforms(models, time);
+            instancedProgram.use();
+            instancedProgram.setMat4("viewProjection"_u, viewProjection);
+            cubes.setTransforms(models);
+            cubes.draw();
+        });
+
+        cout << cubeCount << " cubes: per-draw " << perDraw << " ms/frame, instanced " << instanced
+             << " ms/frame" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "parametricMesher.h"
+#include "glStateApi.h"
+#include <GL/glew.h>
+#include <cmath>
+
+using namespace std;
+
+const double TAU = 6.283185307179586476925286766559;
+
+const unsigned int ParametricMesher::RESTART_INDEX;
+
+vector<glm::vec2> ParametricMesher::getUnitCircle(int segments) {
+    vector<glm::vec2> circle(segments);
+    for (int i = 0; i < segments; i++) {
+        double angle = TAU * i / segments;
+        circle[i] = glm::vec2(static_cast<float>(cos(angle)), static_cast<float>(sin(angle)));
+    }
+    return circle;
+}
+
+void ParametricMesher::addVertex(ParametricMesh &mesh, const glm::vec3 &position, const glm::vec3 &normal) {
+    mesh.vertices.insert(mesh.vertices.end(), {position.x, position.y, position.z, normal.x, normal.y, normal.z});
+}
+
+// The last pair repeats the first, closing the strip without a seam vertex
+void ParametricMesher::addStrip(ParametricMesh &mesh, unsigned int firstRing, int firstRingSize,
+                                unsigned int secondRing, int secondRingSize, int segments) {
+    for (int i = 0; i <= segments; i++) {
+        mesh.indices.push_back(firstRing + static_cast<unsigned int>(i % firstRingSize));
+        mesh.indices.push_back(secondRing + static_cast<unsigned int>(i % secondRingSize));
+    }
+    mesh.indices.push_back(RESTART_INDEX);
+}
+
+ParametricMesh ParametricMesher::torus(float majorRadius, float minorRadius, int majorSegments,
+                                       int minorSegments) {
+    vector<glm::vec2> major = getUnitCircle(majorSegments);
+    vector<glm::vec2> minor = getUnitCircle(minorSegments);
+
+    ParametricMesh mesh;
+    mesh.vertices.reserve(static_cast<size_t>(majorSegments) * minorSegments * FLOATS_PER_VERTEX);
+    mesh.indices.reserve(static_cast<size_t>(majorSegments) * (2 * minorSegments + 3));
+
+    for (const glm::vec2 &around: major) {
+        for (const glm::vec2 &tube: minor) {
+            glm::vec3 normal(tube.x * around.x, tube.x * around.y, tube.y);
+            glm::vec3 center(majorRadius * around.x, majorRadius * around.y, 0.0f);
+            addVertex(mesh, center + minorRadius * normal, normal);
+        }
+    }
+
+    for (int i = 0; i < majorSegments; i++) {
+        auto ring = static_cast<unsigned int>(i * minorSegments);
+        auto nextRing = static_cast<unsigned int>((i + 1) % majorSegments * minorSegments);
+        addStrip(mesh, ring, minorSegments, nextRing, minorSegments, minorSegments);
+    }
+
+    return mesh;
+}
+
+ParametricMesh ParametricMesher::sphere(float radius, int stacks, int slices) {
+    vector<glm::vec2> ring = getUnitCircle(slices);
+    // Half a circle from the north pole to the south pole
+    vector<glm::vec2> meridian = getUnitCircle(2 * stacks);
+
+    ParametricMesh mesh;
+    mesh.vertices.reserve((static_cast<size_t>(stacks - 1) * slices + 2) * FLOATS_PER_VERTEX);
+    mesh.indices.reserve(static_cast<size_t>(stacks) * (2 * slices + 3));
+
+    addVertex(mesh, glm::vec3(0.0f, radius, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    for (int stack = 1; stack < stacks; stack++) {
+        float y = meridian[stack].x;
+        float ringRadius = meridian[stack].y;
+        for (const glm::vec2 &around: ring) {
+            glm::vec3 normal(ringRadius * around.x, y, ringRadius * around.y);
+            addVertex(mesh, radius * normal, normal);
+        }
+    }
+    addVertex(mesh, glm::vec3(0.0f, -radius, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+
+    auto southPole = static_cast<unsigned int>((stacks - 1) * slices + 1);
+    for (int stack = 0; stack < stacks; stack++) {
+        unsigned int upper = stack == 0 ? 0 : static_cast<unsigned int>((stack - 1) * slices + 1);
+        unsigned int lower = stack == stacks - 1 ? southPole : static_cast<unsigned int>(stack * slices + 1);
+        addStrip(mesh, lower, stack == stacks - 1 ? 1 : slices, upper, stack == 0 ? 1 : slices, slices);
+    }
+
+    return mesh;
+}
+
+ParametricMesh ParametricMesher::cylinder(float radius, float height, int slices) {
+    vector<glm::vec2> ring = getUnitCircle(slices);
+
+    ParametricMesh mesh;
+    mesh.vertices.reserve((static_cast<size_t>(4) * slices + 2) * FLOATS_PER_VERTEX);
+    mesh.indices.reserve(static_cast<size_t>(3) * (2 * slices + 3));
+
+    glm::vec3 down(0.0f, -1.0f, 0.0f);
+    glm::vec3 up(0.0f, 1.0f, 0.0f);
+
+    addVertex(mesh, glm::vec3(0.0f), down);
+    for (const glm::vec2 &around: ring) {
+        addVertex(mesh, glm::vec3(radius * around.x, 0.0f, radius * around.y), down);
+    }
+    for (const glm::vec2 &around: ring) {
+        glm::vec3 outward(around.x, 0.0f, around.y);
+        addVertex(mesh, radius * outward, outward);
+    }
+    for (const glm::vec2 &around: ring) {
+        glm::vec3 outward(around.x, 0.0f, around.y);
+        addVertex(mesh, radius * outward + height * up, outward);
+    }
+    for (const glm::vec2 &around: ring) {
+        addVertex(mesh, glm::vec3(radius * around.x, height, radius * around.y), up);
+    }
+    addVertex(mesh, glm::vec3(0.0f, height, 0.0f), up);
+
+    auto rimSize = static_cast<unsigned int>(slices);
+    addStrip(mesh, 0, 1, 1, slices, slices);
+    addStrip(mesh, 1 + rimSize, slices, 1 + 2 * rimSize, slices, slices);
+    addStrip(mesh, 1 + 3 * rimSize, slices, 1 + 4 * rimSize, 1, slices);
+
+    return mesh;
+}
+
+ParametricMeshBuffers ParametricMesher::upload(const ParametricMesh &mesh, const VertexFormat &format) {
+    ParametricMeshBuffers buffers{0, 0, 0, static_cast<int>(mesh.indices.size())};
+    if (mesh.indices.empty()) {
+        return buffers;
+    }
+
+    glGenVertexArrays(1, &buffers.vertexArray);
+    glGenBuffers(1, &buffers.vertexBuffer);
+    glGenBuffers(1, &buffers.elementBuffer);
+
+    GlState::bindVertexArray(buffers.vertexArray);
+
+    GlState::bindBuffer(GL_ARRAY_BUFFER, buffers.vertexBuffer);
+    vector<unsigned char> vertices = format.pack(mesh.vertices);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertices.size()), vertices.data(), GL_STATIC_DRAW);
+
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.elementBuffer);
+    unsigned long elementBufferSize = mesh.indices.size() * sizeof(unsigned int);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long> (elementBufferSize), mesh.indices.data(),
+                 GL_STATIC_DRAW);
+
+    format.setAttributePointers();
+
+    GlState::bindVertexArray(0);
+
+    return buffers;
+}
+
+void ParametricMesher::draw(const ParametricMeshBuffers &buffers) {
+    if (buffers.indexCount == 0) {
+        return;
+    }
+
+    // The restart index is context state rather than part of the vertex array, so it is set on every draw
+    GlState::setEnabled(GL_PRIMITIVE_RESTART, true);
+    glPrimitiveRestartIndex(RESTART_INDEX);
+    GlState::bindVertexArray(buffers.vertexArray);
+    GlState::drawElements(GL_TRIANGLE_STRIP, buffers.indexCount, GL_UNSIGNED_INT, nullptr);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "vertexFormat.h"
+#include <vector>
+#include <glm/glm.hpp>
+
+struct ParametricMesh {
+    // Interleaved position and unit normal, FLOATS_PER_VERTEX per vertex
+    std::vector<float> vertices;
+    // Triangle strips, each followed by RESTART_INDEX
+    std::vector<unsigned int> indices;
+};
+
+struct ParametricMeshBuffers {
+    unsigned int vertexArray;
+    unsigned int vertexBuffer;
+    unsigned int elementBuffer;
+    int indexCount;
+};
+
+// Closed surfaces built ring by ring. Every vertex is stored once, including those on the seams and the
+// poles, and sin/cos are computed once per segment of a ring rather than per vertex. Each pair of neighboring
+// rings is one triangle strip; the strips of a mesh are drawn with a single call using primitive restart.
+// Outward faces are counter-clockwise, so the meshes can be drawn with GL_CULL_FACE and lit.
+class ParametricMesher {
+public:
+    static const int FLOATS_PER_VERTEX = 6;
+    static const unsigned int RESTART_INDEX = 0xFFFFFFFF;
+
+    // Ring of majorRadius around the z axis in the xy plane, tube of minorRadius
+    static ParametricMesh torus(float majorRadius, float minorRadius, int majorSegments, int minorSegments);
+
+    // Centered at the origin with the poles on the y axis
+    static ParametricMesh sphere(float radius, int stacks, int slices);
+
+    // Capped, standing on y = 0 around the y axis. The rims are stored twice, for the side's and the caps' normals.
+    static ParametricMesh cylinder(float radius, float height, int slices);
+
+    // Position goes to attribute 0 and the normal to attribute 1, as in the Phong scenes' shaders. The default
+    // format stores half-float positions and packed normals.
+    static ParametricMeshBuffers upload(const ParametricMesh &mesh,
+                                        const VertexFormat &format = VertexFormat::compactPositionNormal());
+
+    static void draw(const ParametricMeshBuffers &buffers);
+
+private:
+    // (cos, sin) of segments steps around a circle
+    static std::vector<glm::vec2> getUnitCircle(int segments);
+
+    static void addVertex(ParametricMesh &mesh, const glm::vec3 &position, const glm::vec3 &normal);
+
+    // One strip between two rings of the same segment count, either of which may be a single vertex (a pole)
+    static void addStrip(ParametricMesh &mesh, unsigned int firstRing, int firstRingSize, unsigned int secondRing,
+                         int secondRingSize, int segments);
+};
@@ -0,0 +1,186 @@
+#include "vertexFormat.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+int VertexFormat::getComponentSize(VertexAttributeType type) {
+    switch (type) {
+        case VertexAttributeType::Float:
+            return 4;
+        case VertexAttributeType::HalfFloat:
+        case VertexAttributeType::UnsignedShortNormalized:
+            return 2;
+        case VertexAttributeType::UnsignedByteNormalized:
+            return 1;
+        case VertexAttributeType::PackedNormal:
+        default:
+            return 0;
+    }
+}
+
+VertexFormat &VertexFormat::add(unsigned int location, int components, VertexAttributeType type) {
+    int size = type == VertexAttributeType::PackedNormal ? 4 : components * getComponentSize(type);
+    attributes.push_back({location, components, type, stride});
+    stride += (size + 3) / 4 * 4;
+    floatsPerVertex += components;
+    return *this;
+}
+
+const vector<VertexAttribute> &VertexFormat::getAttributes() const {
+    return attributes;
+}
+
+int VertexFormat::getStride() const {
+    return stride;
+}
+
+int VertexFormat::getFloatsPerVertex() const {
+    return floatsPerVertex;
+}
+
+uint16_t VertexFormat::toHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    if (magnitude > 0x7F800000) {
+        return sign | 0x7E00;
+    }
+    if (magnitude >= 0x47800000) {
+        return sign | 0x7C00;
+    }
+
+    // Below 2^-14 the half is subnormal: the mantissa, implicit bit included, shifted right past the exponent
+    if (magnitude < 0x38800000) {
+        auto exponent = static_cast<int>(magnitude >> 23);
+        if (exponent < 102) {
+            return sign;
+        }
+        uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+        int shift = 126 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // Rebias the exponent from 127 to 15; a carry out of the mantissa correctly bumps the exponent
+    uint32_t half = (magnitude - 0x38000000) >> 13;
+    uint32_t remainder = magnitude & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+uint32_t VertexFormat::packNormal(float x, float y, float z, float w) {
+    auto component = [](float value, float scale, uint32_t mask) {
+        auto quantized = static_cast<int32_t>(lround(clamp(value, -1.0f, 1.0f) * scale));
+        return static_cast<uint32_t>(quantized) & mask;
+    };
+    return component(x, 511.0f, 0x3FF) | component(y, 511.0f, 0x3FF) << 10 | component(z, 511.0f, 0x3FF) << 20 |
+           component(w, 1.0f, 0x3) << 30;
+}
+
+void VertexFormat::writeComponent(unsigned char *destination, int index, VertexAttributeType type, float value) {
+    switch (type) {
+        case VertexAttributeType::Float:
+            memcpy(destination + 4 * index, &value, 4);
+            break;
+        case VertexAttributeType::HalfFloat: {
+            uint16_t half = toHalf(value);
+            memcpy(destination + 2 * index, &half, 2);
+            break;
+        }
+        case VertexAttributeType::UnsignedShortNormalized: {
+            auto quantized = static_cast<uint16_t>(lround(clamp(value, 0.0f, 1.0f) * 65535.0f));
+            memcpy(destination + 2 * index, &quantized, 2);
+            break;
+        }
+        case VertexAttributeType::UnsignedByteNormalized:
+            destination[index] = static_cast<unsigned char>(lround(clamp(value, 0.0f, 1.0f) * 255.0f));
+            break;
+        case VertexAttributeType::PackedNormal:
+            break;
+    }
+}
+
+vector<unsigned char> VertexFormat::pack(const float *source, size_t vertexCount) const {
+    vector<unsigned char> packed(vertexCount * stride);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        const float *input = source + vertex * floatsPerVertex;
+        unsigned char *output = packed.data() + vertex * stride;
+
+        for (const VertexAttribute &attribute: attributes) {
+            unsigned char *destination = output + attribute.offset;
+            if (attribute.type == VertexAttributeType::PackedNormal) {
+                float components[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                copy(input, input + min(attribute.components, 4), components);
+                uint32_t normal = packNormal(components[0], components[1], components[2], components[3]);
+                memcpy(destination, &normal, 4);
+            } else {
+                for (int i = 0; i < attribute.components; i++) {
+                    writeComponent(destination, i, attribute.type, input[i]);
+                }
+            }
+            input += attribute.components;
+        }
+    }
+    return packed;
+}
+
+vector<unsigned char> VertexFormat::pack(const vector<float> &source) const {
+    return pack(source.data(), floatsPerVertex == 0 ? 0 : source.size() / floatsPerVertex);
+}
+
+// Packed types are always read as four components; a vec3 in the shader ignores the fourth
+VertexFormat::GlAttribute VertexFormat::getGlAttribute(const VertexAttribute &attribute) {
+    switch (attribute.type) {
+        case VertexAttributeType::HalfFloat:
+            return {attribute.components, GL_HALF_FLOAT, GL_FALSE};
+        case VertexAttributeType::PackedNormal:
+            return {4, GL_INT_2_10_10_10_REV, GL_TRUE};
+        case VertexAttributeType::UnsignedShortNormalized:
+            return {attribute.components, GL_UNSIGNED_SHORT, GL_TRUE};
+        case VertexAttributeType::UnsignedByteNormalized:
+            return {attribute.components, GL_UNSIGNED_BYTE, GL_TRUE};
+        case VertexAttributeType::Float:
+        default:
+            return {attribute.components, GL_FLOAT, GL_FALSE};
+    }
+}
+
+void VertexFormat::setAttributePointers() const {
+    for (const VertexAttribute &attribute: attributes) {
+        GlAttribute glAttribute = getGlAttribute(attribute);
+        glVertexAttribPointer(attribute.location, glAttribute.size, glAttribute.type, glAttribute.normalized, stride,
+                              reinterpret_cast<void *>(static_cast<uintptr_t>(attribute.offset)));
+        glEnableVertexAttribArray(attribute.location);
+    }
+}
+
+void VertexFormat::setAttributeFormats(unsigned int binding) const {
+    for (const VertexAttribute &attribute: attributes) {
+        GlAttribute glAttribute = getGlAttribute(attribute);
+        glVertexAttribFormat(attribute.location, glAttribute.size, glAttribute.type, glAttribute.normalized,
+                             static_cast<unsigned int>(attribute.offset));
+        glVertexAttribBinding(attribute.location, binding);
+        glEnableVertexAttribArray(attribute.location);
+    }
+}
+
+VertexFormat VertexFormat::compactPositionNormal() {
+    return VertexFormat().add(0, 3, VertexAttributeType::HalfFloat).add(1, 3, VertexAttributeType::PackedNormal);
+}
+
+VertexFormat VertexFormat::compactPositionColor() {
+    return VertexFormat().add(0, 3, VertexAttributeType::HalfFloat)
+            .add(1, 3, VertexAttributeType::UnsignedByteNormalized);
+}
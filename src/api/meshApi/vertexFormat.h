@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// How an attribute is stored in the vertex buffer. Everything except Float is a lossy quantization of the
+// float source data.
+enum class VertexAttributeType {
+    Float,
+    // GL_HALF_FLOAT: 11 significant bits, e.g. steps of 1/1024 up to 1 and of 1/64 up to 32
+    HalfFloat,
+    // GL_INT_2_10_10_10_REV: three signed normalized components in 4 bytes, for unit normals and tangents
+    PackedNormal,
+    // GL_UNSIGNED_SHORT normalized to [0, 1], for texture coordinates that do not repeat
+    UnsignedShortNormalized,
+    // GL_UNSIGNED_BYTE normalized to [0, 1], for colors
+    UnsignedByteNormalized
+};
+
+struct VertexAttribute {
+    unsigned int location;
+    int components;
+    VertexAttributeType type;
+    // Bytes from the start of the vertex
+    int offset;
+};
+
+// Interleaved vertex layout described attribute by attribute, e.g.
+//   VertexFormat().add(0, 3, VertexAttributeType::HalfFloat).add(1, 3, VertexAttributeType::PackedNormal)
+// Source vertices are interleaved floats with the attributes' components in the same order; pack() quantizes
+// them and setAttributePointers() issues the matching glVertexAttribPointer calls. Every attribute starts on
+// a 4-byte boundary.
+class VertexFormat {
+public:
+    VertexFormat &add(unsigned int location, int components,
+                      VertexAttributeType type = VertexAttributeType::Float);
+
+    const std::vector<VertexAttribute> &getAttributes() const;
+
+    // In bytes
+    int getStride() const;
+
+    int getFloatsPerVertex() const;
+
+    std::vector<unsigned char> pack(const float *source, size_t vertexCount) const;
+
+    std::vector<unsigned char> pack(const std::vector<float> &source) const;
+
+    // For the bound vertex array, reading from the buffer bound to GL_ARRAY_BUFFER at offset 0
+    void setAttributePointers() const;
+
+    // Same attributes through GL_ARB_vertex_attrib_binding, reading from whatever buffer is later attached to
+    // binding with glBindVertexBuffer
+    void setAttributeFormats(unsigned int binding) const;
+
+    // Half-float position and packed normal, 12 bytes instead of 24
+    static VertexFormat compactPositionNormal();
+
+    // Half-float position and 8-bit color, 12 bytes instead of 24
+    static VertexFormat compactPositionColor();
+
+    // Rounds to nearest even; overflows to infinity
+    static uint16_t toHalf(float value);
+
+    static uint32_t packNormal(float x, float y, float z, float w = 0.0f);
+
+private:
+    struct GlAttribute {
+        int size;
+        unsigned int type;
+        unsigned char normalized;
+    };
+
+    std::vector<VertexAttribute> attributes;
+    int stride = 0;
+    int floatsPerVertex = 0;
+
+    static int getComponentSize(VertexAttributeType type);
+
+    static GlAttribute getGlAttribute(const VertexAttribute &attribute);
+
+    static void writeComponent(unsigned char *destination, int index, VertexAttributeType type, float value);
+};
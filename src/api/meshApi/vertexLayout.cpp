@@ -0,0 +1,195 @@
+#include "vertexLayout.h"
+#include "glStateApi.h"
+#include <GL/glew.h>
+#include <algorithm>
+
+using namespace std;
+
+VertexLayout::VertexLayout(const VertexFormat &format) {
+    addBuffer(format);
+}
+
+VertexLayout &VertexLayout::addBuffer(const VertexFormat &format, unsigned int divisor) {
+    buffers.push_back({format, divisor});
+    for (const VertexAttribute &attribute: format.getAttributes()) {
+        key += to_string(attribute.location) + "," + to_string(attribute.components) + "," +
+               to_string(static_cast<int>(attribute.type)) + "," + to_string(attribute.offset) + ";";
+    }
+    key += to_string(format.getStride()) + "/" + to_string(divisor) + "|";
+    return *this;
+}
+
+const vector<VertexBufferLayout> &VertexLayout::getBuffers() const {
+    return buffers;
+}
+
+const string &VertexLayout::getKey() const {
+    return key;
+}
+
+VertexArrayCache::State &VertexArrayCache::getState() {
+    static State state;
+    return state;
+}
+
+bool VertexArrayCache::usesAttribBinding() {
+    State &state = getState();
+    if (state.attribBinding < 0) {
+        state.attribBinding = GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding ? 1 : 0;
+    }
+    return state.attribBinding == 1;
+}
+
+size_t VertexArrayCache::getVertexArrayCount() {
+    return getState().entries.size();
+}
+
+// The buffers only take part when they are baked into the vertex array
+string VertexArrayCache::getEntryKey(const VertexLayout &layout, const vector<unsigned int> &vertexBuffers,
+                                     unsigned int elementBuffer) {
+    if (usesAttribBinding()) {
+        return layout.getKey();
+    }
+
+    string key = layout.getKey() + "@";
+    for (unsigned int vertexBuffer: vertexBuffers) {
+        key += to_string(vertexBuffer) + ",";
+    }
+    return key + to_string(elementBuffer);
+}
+
+VertexArrayCache::Entry VertexArrayCache::createEntry(const VertexLayout &layout,
+                                                      const vector<unsigned int> &vertexBuffers,
+                                                      unsigned int elementBuffer) {
+    const vector<VertexBufferLayout> &buffers = layout.getBuffers();
+    Entry entry{0, vector<unsigned int>(buffers.size(), 0), 0};
+    glGenVertexArrays(1, &entry.vertexArray);
+    GlState::bindVertexArray(entry.vertexArray);
+
+    for (size_t binding = 0; binding < buffers.size(); binding++) {
+        const VertexBufferLayout &buffer = buffers[binding];
+        if (usesAttribBinding()) {
+            buffer.format.setAttributeFormats(static_cast<unsigned int>(binding));
+            glVertexBindingDivisor(static_cast<unsigned int>(binding), buffer.divisor);
+            continue;
+        }
+
+        entry.vertexBuffers[binding] = binding < vertexBuffers.size() ? vertexBuffers[binding] : 0;
+        GlState::bindBuffer(GL_ARRAY_BUFFER, entry.vertexBuffers[binding]);
+        buffer.format.setAttributePointers();
+        for (const VertexAttribute &attribute: buffer.format.getAttributes()) {
+            glVertexAttribDivisor(attribute.location, buffer.divisor);
+        }
+    }
+
+    if (!usesAttribBinding()) {
+        entry.elementBuffer = elementBuffer;
+        GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    }
+    return entry;
+}
+
+void VertexArrayCache::bind(const VertexLayout &layout, const vector<unsigned int> &vertexBuffers,
+                            unsigned int elementBuffer) {
+    State &state = getState();
+    string key = getEntryKey(layout, vertexBuffers, elementBuffer);
+    auto found = state.entries.find(key);
+    if (found == state.entries.end()) {
+        found = state.entries.emplace(key, createEntry(layout, vertexBuffers, elementBuffer)).first;
+    }
+
+    Entry &entry = found->second;
+    GlState::bindVertexArray(entry.vertexArray);
+    if (!usesAttribBinding()) {
+        return;
+    }
+
+    const vector<VertexBufferLayout> &buffers = layout.getBuffers();
+    for (size_t binding = 0; binding < buffers.size() && binding < vertexBuffers.size(); binding++) {
+        if (entry.vertexBuffers[binding] != vertexBuffers[binding]) {
+            glBindVertexBuffer(static_cast<unsigned int>(binding), vertexBuffers[binding], 0,
+                               buffers[binding].format.getStride());
+            entry.vertexBuffers[binding] = vertexBuffers[binding];
+        }
+    }
+    // The element buffer binding belongs to the vertex array, and GlState forgets it whenever that changes
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+}
+
+void VertexArrayCache::bind(const LayoutMesh &mesh) {
+    bind(mesh.layout, mesh.vertexBuffers, mesh.elementBuffer);
+}
+
+void VertexArrayCache::draw(const LayoutMesh &mesh, unsigned int mode) {
+    bind(mesh);
+    if (mesh.indexCount > 0) {
+        GlState::drawElements(mode, mesh.indexCount, GL_UNSIGNED_INT, nullptr);
+    } else {
+        GlState::drawArrays(mode, 0, mesh.vertexCount);
+    }
+}
+
+// Both buffers go through GL_ARRAY_BUFFER, so the upload leaves the bound vertex array's element buffer alone
+LayoutMesh VertexArrayCache::upload(const VertexLayout &layout, const vector<float> &vertices,
+                                    const vector<unsigned int> &indices) {
+    LayoutMesh mesh{layout, vector<unsigned int>(layout.getBuffers().size(), 0), 0, 0,
+                    static_cast<int>(indices.size())};
+    if (layout.getBuffers().empty()) {
+        return mesh;
+    }
+
+    const VertexFormat &format = layout.getBuffers().front().format;
+    vector<unsigned char> packed = format.pack(vertices);
+    mesh.vertexCount = format.getStride() == 0 ? 0 : static_cast<int>(packed.size()) / format.getStride();
+
+    glGenBuffers(1, &mesh.vertexBuffers[0]);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (packed.size()), packed.data(), GL_STATIC_DRAW);
+
+    if (!indices.empty()) {
+        glGenBuffers(1, &mesh.elementBuffer);
+        GlState::bindBuffer(GL_ARRAY_BUFFER, mesh.elementBuffer);
+        unsigned long elementBufferSize = indices.size() * sizeof(unsigned int);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<long> (elementBufferSize), indices.data(), GL_STATIC_DRAW);
+    }
+
+    return mesh;
+}
+
+void VertexArrayCache::release(LayoutMesh &mesh) {
+    vector<unsigned int> released = mesh.vertexBuffers;
+    released.push_back(mesh.elementBuffer);
+    released.erase(remove(released.begin(), released.end(), 0u), released.end());
+    auto isReleased = [&](unsigned int buffer) {
+        return buffer != 0 && find(released.begin(), released.end(), buffer) != released.end();
+    };
+
+    State &state = getState();
+    for (auto it = state.entries.begin(); it != state.entries.end();) {
+        Entry &entry = it->second;
+        bool usesReleased = isReleased(entry.elementBuffer) ||
+                            any_of(entry.vertexBuffers.begin(), entry.vertexBuffers.end(), isReleased);
+        if (usesReleased && !usesAttribBinding()) {
+            glDeleteVertexArrays(1, &entry.vertexArray);
+            GlState::onVertexArrayDeleted(entry.vertexArray);
+            it = state.entries.erase(it);
+            continue;
+        }
+        // A deleted name may come back from glGenBuffers, so it must not look attached anymore
+        for (unsigned int &vertexBuffer: entry.vertexBuffers) {
+            if (isReleased(vertexBuffer)) {
+                vertexBuffer = 0;
+            }
+        }
+        ++it;
+    }
+
+    for (unsigned int buffer: released) {
+        glDeleteBuffers(1, &buffer);
+        GlState::onBufferDeleted(buffer);
+    }
+    fill(mesh.vertexBuffers.begin(), mesh.vertexBuffers.end(), 0);
+    mesh.elementBuffer = 0;
+    mesh.vertexCount = 0;
+    mesh.indexCount = 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "vertexFormat.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct VertexBufferLayout {
+    VertexFormat format;
+    // 0 advances per vertex, n once every n instances
+    unsigned int divisor;
+};
+
+// Which vertex buffers a vertex array reads and how: one VertexFormat per buffer binding, e.g. an interleaved
+// mesh buffer at binding 0 and per-instance data at binding 1
+class VertexLayout {
+public:
+    VertexLayout() = default;
+
+    explicit VertexLayout(const VertexFormat &format);
+
+    VertexLayout &addBuffer(const VertexFormat &format, unsigned int divisor = 0);
+
+    const std::vector<VertexBufferLayout> &getBuffers() const;
+
+    // Equal for layouts that set up the same attributes
+    const std::string &getKey() const;
+
+private:
+    std::vector<VertexBufferLayout> buffers;
+    std::string key;
+};
+
+// Vertex and index buffers created by VertexArrayCache::upload, drawn after VertexArrayCache::bind(mesh)
+struct LayoutMesh {
+    VertexLayout layout;
+    std::vector<unsigned int> vertexBuffers;
+    unsigned int elementBuffer;
+    int vertexCount;
+    int indexCount;
+};
+
+// Hands out vertex arrays by layout, so equal layouts over equal buffers never get a second one. With
+// GL_ARB_vertex_attrib_binding (core in 4.3) the attribute formats live in one vertex array per layout and
+// bind() only swaps the buffers attached to it; without it there is one vertex array per layout and buffer set.
+class VertexArrayCache {
+public:
+    // One interleaved buffer packed to the layout's first format, plus an index buffer unless indices is empty
+    static LayoutMesh upload(const VertexLayout &layout, const std::vector<float> &vertices,
+                             const std::vector<unsigned int> &indices = {});
+
+    // Binds a vertex array reading vertexBuffers[i] at the layout's binding i and indices from elementBuffer
+    static void bind(const VertexLayout &layout, const std::vector<unsigned int> &vertexBuffers,
+                     unsigned int elementBuffer = 0);
+
+    static void bind(const LayoutMesh &mesh);
+
+    // Binds the mesh and draws all of its indices, or all of its vertices when it has none
+    static void draw(const LayoutMesh &mesh, unsigned int mode);
+
+    // Deletes the mesh's buffers and the vertex arrays that only existed for them
+    static void release(LayoutMesh &mesh);
+
+    static bool usesAttribBinding();
+
+    static size_t getVertexArrayCount();
+
+private:
+    struct Entry {
+        unsigned int vertexArray;
+        // What is attached to each binding, to skip glBindVertexBuffer calls that would change nothing
+        std::vector<unsigned int> vertexBuffers;
+        unsigned int elementBuffer;
+    };
+
+    struct State {
+        // Decided on first use, when a context exists
+        int attribBinding = -1;
+        std::unordered_map<std::string, Entry> entries;
+    };
+
+    static State &getState();
+
+    static std::string getEntryKey(const VertexLayout &layout, const std::vector<unsigned int> &vertexBuffers,
+                                   unsigned int elementBuffer);
+
+    static Entry createEntry(const VertexLayout &layout, const std::vector<unsigned int> &vertexBuffers,
+                             unsigned int elementBuffer);
+};
@@ -0,0 +1,224 @@
+#include "profilerApi.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+Profiler::State &Profiler::getState() {
+    static State state;
+    return state;
+}
+
+int64_t Profiler::getCpuTime() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - getState().start).count();
+}
+
+void Profiler::start(int maxFrames) {
+    State &state = getState();
+    releasePools();
+    state.events.clear();
+    state.openScopes.clear();
+    state.frame = 0;
+    state.droppedGpuFrames = 0;
+    state.maxFrames = maxFrames;
+    state.isGpuTimerSupported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    state.start = chrono::steady_clock::now();
+
+    // Both clocks are sampled once; their drift over a few hundred frames is far below a microsecond
+    if (state.isGpuTimerSupported) {
+        GLint64 gpuTime = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+        state.gpuClockOffset = getCpuTime() - gpuTime;
+    }
+    state.isRecording = maxFrames > 0;
+}
+
+bool Profiler::isRecording() {
+    return getState().isRecording;
+}
+
+// Pools only grow, so after the first frames no more queries are generated
+unsigned int Profiler::writeTimestamp(QueryPool &pool, size_t index) {
+    if (index >= pool.queries.size()) {
+        size_t oldSize = pool.queries.size();
+        pool.queries.resize(max<size_t>(index + 1, oldSize * 2));
+        glGenQueries(static_cast<int>(pool.queries.size() - oldSize), pool.queries.data() + oldSize);
+    }
+    unsigned int query = pool.queries[index];
+    glQueryCounter(query, GL_TIMESTAMP);
+    pool.lastQuery = query;
+    return query;
+}
+
+void Profiler::beginScope(const char *name) {
+    State &state = getState();
+    if (!state.isRecording) {
+        return;
+    }
+
+    size_t event = state.events.size();
+    state.events.push_back({name, state.frame, static_cast<int>(state.openScopes.size()), getCpuTime(), -1, -1, -1});
+
+    size_t slot = 0;
+    if (state.isGpuTimerSupported) {
+        QueryPool &pool = state.pools[state.frame % 2];
+        slot = pool.events.size();
+        pool.events.push_back(event);
+        writeTimestamp(pool, 2 * slot);
+    }
+    state.openScopes.push_back({event, slot});
+}
+
+void Profiler::endScope() {
+    State &state = getState();
+    if (!state.isRecording || state.openScopes.empty()) {
+        return;
+    }
+
+    OpenScope scope = state.openScopes.back();
+    state.openScopes.pop_back();
+    if (state.isGpuTimerSupported) {
+        writeTimestamp(state.pools[state.frame % 2], 2 * scope.slot + 1);
+    }
+    state.events[scope.event].cpuEnd = getCpuTime();
+}
+
+void Profiler::beginFrame() {
+    beginScope("frame");
+}
+
+void Profiler::endFrame() {
+    State &state = getState();
+    if (!state.isRecording) {
+        return;
+    }
+
+    // Scopes left open by the frame end with it
+    while (!state.openScopes.empty()) {
+        endScope();
+    }
+
+    // The other pool holds the previous frame, and the next frame is going to write into it
+    resolvePool(state.pools[(state.frame + 1) % 2], false);
+
+    state.frame++;
+    if (state.frame >= state.maxFrames) {
+        state.isRecording = false;
+        cout << "Profiler trace is full after " << state.frame << " frames" << endl;
+    }
+}
+
+// Timestamps complete in the order they were written, so the last one tells whether the whole pool is done
+void Profiler::resolvePool(QueryPool &pool, bool wait) {
+    if (pool.events.empty()) {
+        return;
+    }
+
+    State &state = getState();
+    GLint isAvailable = GL_FALSE;
+    glGetQueryObjectiv(pool.lastQuery, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+    if (isAvailable || wait) {
+        for (size_t slot = 0; slot < pool.events.size(); slot++) {
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(pool.queries[2 * slot], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(pool.queries[2 * slot + 1], GL_QUERY_RESULT, &end);
+
+            ProfileEvent &event = state.events[pool.events[slot]];
+            event.gpuBegin = static_cast<int64_t>(begin) + state.gpuClockOffset;
+            event.gpuEnd = static_cast<int64_t>(end) + state.gpuClockOffset;
+        }
+    } else {
+        state.droppedGpuFrames++;
+    }
+    pool.events.clear();
+}
+
+void Profiler::releasePools() {
+    for (QueryPool &pool: getState().pools) {
+        if (!pool.queries.empty()) {
+            glDeleteQueries(static_cast<int>(pool.queries.size()), pool.queries.data());
+        }
+        pool = QueryPool();
+    }
+}
+
+namespace {
+
+void writeTraceString(std::ostream &output, const char *value) {
+    output << '"';
+    for (const char *character = value; *character; character++) {
+        if (*character == '"' || *character == '\\') {
+            output << '\\';
+        }
+        output << *character;
+    }
+    output << '"';
+}
+
+void writeTraceEvent(std::ostream &output, const ProfileEvent &event, int threadId, int64_t begin, int64_t end) {
+    output << ",\n  {\"name\": ";
+    writeTraceString(output, event.name);
+    // trace_event wants microseconds
+    output << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << threadId << ", \"ts\": " << begin / 1000.0
+           << ", \"dur\": " << (end - begin) / 1000.0 << ", \"args\": {\"frame\": " << event.frame << "}}";
+}
+
+}
+
+bool Profiler::writeChromeTrace(const string &filePath, const string &processName) {
+    State &state = getState();
+    while (!state.openScopes.empty()) {
+        endScope();
+    }
+    state.isRecording = false;
+    for (QueryPool &pool: state.pools) {
+        resolvePool(pool, true);
+    }
+    releasePools();
+
+    std::stringstream json;
+    json << fixed;
+    json << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    json << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": ";
+    writeTraceString(json, processName.c_str());
+    json << "}},\n";
+    json << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"CPU\"}},\n";
+    json << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, \"args\": {\"name\": \"GPU\"}}";
+
+    int gpuEvents = 0;
+    for (const ProfileEvent &event: state.events) {
+        writeTraceEvent(json, event, 1, event.cpuBegin, event.cpuEnd);
+        if (event.gpuBegin >= 0 && event.gpuEnd >= event.gpuBegin) {
+            writeTraceEvent(json, event, 2, event.gpuBegin, event.gpuEnd);
+            gpuEvents++;
+        }
+    }
+    json << "\n]}\n";
+
+    cout << "Profiled " << state.frame << " frames, " << state.events.size() << " CPU and " << gpuEvents
+         << " GPU scopes";
+    if (state.droppedGpuFrames > 0) {
+        cout << ", " << state.droppedGpuFrames << " frames without GPU times";
+    }
+    cout << endl;
+
+    ofstream file(filePath);
+    if (!file.is_open()) {
+        cout << "Failed to write profiler trace! Path: " << filePath << endl;
+        return false;
+    }
+    file << json.str();
+    return true;
+}
+
+ProfileScope::ProfileScope(const char *name) {
+    Profiler::beginScope(name);
+}
+
+ProfileScope::~ProfileScope() {
+    Profiler::endScope();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ProfileEvent {
+    // Not copied: scope names are expected to be string literals
+    const char *name;
+    int frame;
+    int depth;
+    // Nanoseconds since Profiler::start(); the GPU ones are -1 while unknown
+    int64_t cpuBegin;
+    int64_t cpuEnd;
+    int64_t gpuBegin;
+    int64_t gpuEnd;
+};
+
+// Records nested named scopes on the CPU with std::chrono and on the GPU with GL_TIMESTAMP queries, and writes
+// both as a Chrome trace_event JSON that chrome://tracing or Perfetto open directly.
+// Queries come from two pools that swap every frame: a frame's timestamps are read back at the end of the next
+// one, when the GPU is normally done with them. If it is not, that frame keeps only its CPU times instead of
+// waiting. Scopes are free when the profiler has not been started, so they can stay in the demos.
+class Profiler {
+public:
+    static const int DEFAULT_MAX_FRAMES = 600;
+
+    // Needs a current context. Recording stops by itself after maxFrames to keep the trace readable.
+    static void start(int maxFrames = DEFAULT_MAX_FRAMES);
+
+    static bool isRecording();
+
+    static void beginScope(const char *name);
+
+    static void endScope();
+
+    // Open and close the outermost "frame" scope; RenderContext calls them around every swap
+    static void beginFrame();
+
+    static void endFrame();
+
+    // Waits for outstanding GPU results, writes the trace and releases the queries. Returns false if the file
+    // could not be written.
+    static bool writeChromeTrace(const std::string &filePath, const std::string &processName);
+
+private:
+    struct QueryPool {
+        // Two queries per scope, begin and end
+        std::vector<unsigned int> queries;
+        std::vector<size_t> events;
+        unsigned int lastQuery = 0;
+    };
+
+    struct OpenScope {
+        size_t event;
+        size_t slot;
+    };
+
+    struct State {
+        bool isRecording = false;
+        bool isGpuTimerSupported = false;
+        int maxFrames = 0;
+        int frame = 0;
+        int droppedGpuFrames = 0;
+        std::chrono::steady_clock::time_point start;
+        // Added to GPU timestamps to put them on the CPU timeline
+        int64_t gpuClockOffset = 0;
+        std::vector<ProfileEvent> events;
+        std::vector<OpenScope> openScopes;
+        std::array<QueryPool, 2> pools;
+    };
+
+    static State &getState();
+
+    static int64_t getCpuTime();
+
+    static unsigned int writeTimestamp(QueryPool &pool, size_t index);
+
+    static void resolvePool(QueryPool &pool, bool wait);
+
+    static void releasePools();
+};
+
+// Profiles the enclosing block: { ProfileScope scope("plate"); ... }
+class ProfileScope {
+public:
+    explicit ProfileScope(const char *name);
+
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope &) = delete;
+
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
@@ -1,8 +1,11 @@
 #include "shaderApi.h"
+#include "glStateApi.h"
 #include <GL/glew.h>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <sstream>
+#include <cstdlib>
 
 using namespace std;
 
@@ -20,6 +23,15 @@ unsigned int ShaderUtils::CompileShader(unsigned int type, const string &source)
     glShaderSource(id, 1, &src, nullptr);
     glCompileShader(id);
 
+    if (!IsShaderCompiled(id, type)) {
+        glDeleteShader(id);
+        return 0;
+    }
+
+    return id;
+}
+
+bool ShaderUtils::IsShaderCompiled(unsigned int id, unsigned int type) {
     int result;
     glGetShaderiv(id, GL_COMPILE_STATUS, &result);
     if (result == GL_FALSE) {
@@ -30,29 +42,164 @@ unsigned int ShaderUtils::CompileShader(unsigned int type, const string &source)
         string shaderType = (type == GL_VERTEX_SHADER) ? "vertex" : "fragment";
         cout << "Failed to compile " + shaderType + " shader!" << endl;
         cout << message << endl;
+        return false;
+    }
 
-        glDeleteShader(id);
+    return true;
+}
+
+uint64_t hashProgramSource(uint64_t hash, const string &value) {
+    for (char c: value) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    // Separator, so that ("ab", "c") and ("a", "bc") hash differently
+    hash ^= 0xffu;
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+string getGlString(unsigned int name) {
+    const auto *value = reinterpret_cast<const char *>(glGetString(name));
+    return value ? value : "";
+}
+
+bool isProgramBinaryCacheSupported() {
+    if (ShaderUtils::GetProgramBinaryCacheDirectory().empty() || !GLEW_ARB_get_program_binary) {
+        return false;
+    }
+
+    int formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    return formatCount > 0;
+}
+
+// The binary is only valid for the exact driver that produced it, so the driver strings are part of the key
+filesystem::path getProgramBinaryPath(const string &vertexShader, const string &fragmentShader) {
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashProgramSource(hash, vertexShader);
+    hash = hashProgramSource(hash, fragmentShader);
+    hash = hashProgramSource(hash, getGlString(GL_VENDOR));
+    hash = hashProgramSource(hash, getGlString(GL_RENDERER));
+    hash = hashProgramSource(hash, getGlString(GL_VERSION));
+
+    std::stringstream fileName;
+    fileName << hex << hash << ".bin";
+    return filesystem::path(ShaderUtils::GetProgramBinaryCacheDirectory()) / fileName.str();
+}
+
+unsigned int loadProgramBinary(const filesystem::path &binaryPath) {
+    ifstream binaryFile(binaryPath, ios::binary);
+    if (!binaryFile.is_open()) {
         return 0;
     }
 
-    return id;
+    unsigned int format = 0;
+    if (!binaryFile.read(reinterpret_cast<char *>(&format), sizeof(format))) {
+        return 0;
+    }
+    vector<char> binary((istreambuf_iterator<char>(binaryFile)), istreambuf_iterator<char>());
+    if (binary.empty()) {
+        return 0;
+    }
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), static_cast<int>(binary.size()));
+
+    // Rejected after a driver update or by a different GPU: drop the stale entry and compile from source
+    int linked;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        glDeleteProgram(program);
+        error_code error;
+        filesystem::remove(binaryPath, error);
+        return 0;
+    }
+
+    return program;
+}
+
+void saveProgramBinary(unsigned int program, const filesystem::path &binaryPath) {
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    unsigned int format = 0;
+    vector<char> binary(length);
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    error_code error;
+    filesystem::create_directories(binaryPath.parent_path(), error);
+
+    // Written next to the target and renamed, so a concurrent reader never sees a partial file
+    filesystem::path temporaryPath = binaryPath;
+    temporaryPath += ".tmp";
+    {
+        ofstream binaryFile(temporaryPath, ios::binary | ios::trunc);
+        if (!binaryFile.is_open()) {
+            return;
+        }
+        binaryFile.write(reinterpret_cast<const char *>(&format), sizeof(format));
+        binaryFile.write(binary.data(), length);
+    }
+    filesystem::rename(temporaryPath, binaryPath, error);
 }
 
 unsigned int ShaderUtils::CreateShader(const string &vertexShader, const string &fragmentShader) {
+    bool useBinaryCache = isProgramBinaryCacheSupported();
+    filesystem::path binaryPath;
+    if (useBinaryCache) {
+        binaryPath = getProgramBinaryPath(vertexShader, fragmentShader);
+        if (unsigned int cachedProgram = loadProgramBinary(binaryPath); cachedProgram != 0) {
+            return cachedProgram;
+        }
+    }
+
     unsigned int program = glCreateProgram();
     unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
     unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
 
     glAttachShader(program, vs);
     glAttachShader(program, fs);
+    if (useBinaryCache) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(program);
     glValidateProgram(program);
 
     glDeleteShader(vs);
     glDeleteShader(fs);
+
+    int linked;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (useBinaryCache && linked == GL_TRUE) {
+        saveProgramBinary(program, binaryPath);
+    }
     return program;
 }
 
+string &programBinaryCacheDirectory() {
+    static string directory = []() -> string {
+        if (const char *fromEnvironment = getenv("SHADER_CACHE_DIR")) {
+            return fromEnvironment;
+        }
+        error_code error;
+        filesystem::path temporaryDirectory = filesystem::temp_directory_path(error);
+        return error ? "" : (temporaryDirectory / "graphicsLabsShaderCache").string();
+    }();
+    return directory;
+}
+
+void ShaderUtils::SetProgramBinaryCacheDirectory(const string &directory) {
+    programBinaryCacheDirectory() = directory;
+}
+
+string ShaderUtils::GetProgramBinaryCacheDirectory() {
+    return programBinaryCacheDirectory();
+}
+
 unsigned int
 ShaderUtils::CreateShaderFromFiles(const string &vertexShaderFilePath, const string &fragmentShaderFilePath) {
     string vertexShaderSource = readFromFile(vertexShaderFilePath);
@@ -74,62 +221,486 @@ ShaderProgram::createShaderProgramFromStrings(const std::string &vertexShader, c
     return ShaderProgram(shaderProgramId);
 }
 
-ShaderProgram::ShaderProgram(const unsigned int &inputId) : id(inputId) {}
+void UniformLocationTable::insert(const string &name, int location) {
+    if ((count + 1) * 2 > slots.size()) {
+        grow();
+    }
+
+    uint32_t hash = hashUniformName(name.c_str(), name.size());
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        if (slots[i].location < 0) {
+            slots[i] = {hash, location, name};
+            count++;
+            return;
+        }
+        if (slots[i].matches(name.c_str(), name.size(), hash)) {
+            slots[i].location = location;
+            return;
+        }
+    }
+}
+
+// A colliding hash only moves on to the next slot, so a name that is not in the table is never answered
+// with another uniform's location
+int UniformLocationTable::find(const char *name, size_t length, uint32_t hash) const {
+    if (slots.empty()) {
+        return -1;
+    }
+
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        if (slots[i].location < 0 || slots[i].matches(name, length, hash)) {
+            return slots[i].location;
+        }
+    }
+}
+
+void UniformLocationTable::clear() {
+    slots.clear();
+    count = 0;
+}
+
+size_t UniformLocationTable::size() const {
+    return count;
+}
+
+void UniformLocationTable::grow() {
+    vector<Slot> oldSlots = std::move(slots);
+    slots.assign(oldSlots.empty() ? 16 : oldSlots.size() * 2, {0, -1, ""});
+    count = 0;
+    for (const Slot &slot: oldSlots) {
+        if (slot.location >= 0) {
+            insert(slot.name, slot.location);
+        }
+    }
+}
+
+bool UniformBlockBindings::getBindingPoint(const string &blockName, unsigned int &bindingPoint) {
+    unordered_map<string, unsigned int> &bindingPoints = getBindingPoints();
+    auto existing = bindingPoints.find(blockName);
+    if (existing != bindingPoints.end()) {
+        bindingPoint = existing->second;
+        return true;
+    }
+
+    static const int maxBindingPoints = [] {
+        int value = 0;
+        glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &value);
+        return value;
+    }();
+    if (bindingPoints.size() >= static_cast<size_t>(maxBindingPoints)) {
+        cout << "Out of uniform buffer binding points! Block: " << blockName << endl;
+        return false;
+    }
+
+    bindingPoint = static_cast<unsigned int>(bindingPoints.size());
+    bindingPoints.emplace(blockName, bindingPoint);
+    return true;
+}
+
+unordered_map<string, unsigned int> &UniformBlockBindings::getBindingPoints() {
+    static unordered_map<string, unsigned int> bindingPoints;
+    return bindingPoints;
+}
+
+UniformBuffer::UniformBuffer(unsigned int inputId, unsigned int inputBindingPoint, size_t inputSize)
+        : id(inputId), bindingPoint(inputBindingPoint), size(inputSize) {}
+
+UniformBuffer::UniformBuffer(UniformBuffer &&other) noexcept
+        : id(other.id), bindingPoint(other.bindingPoint), size(other.size) {
+    other.id = 0;
+    other.size = 0;
+}
+
+UniformBuffer &UniformBuffer::operator=(UniformBuffer &&other) noexcept {
+    if (this != &other) {
+        if (id != 0) {
+            glDeleteBuffers(1, &id);
+            GlState::onBufferDeleted(id);
+        }
+        id = other.id;
+        bindingPoint = other.bindingPoint;
+        size = other.size;
+        other.id = 0;
+        other.size = 0;
+    }
+    return *this;
+}
+
+UniformBuffer::~UniformBuffer() {
+    if (id != 0) {
+        glDeleteBuffers(1, &id);
+        GlState::onBufferDeleted(id);
+    }
+}
+
+UniformBuffer UniformBuffer::create(const string &blockName, size_t size) {
+    unsigned int bindingPoint = 0;
+    if (!UniformBlockBindings::getBindingPoint(blockName, bindingPoint)) {
+        return {0, 0, 0};
+    }
+
+    unsigned int buffer;
+    glGenBuffers(1, &buffer);
+    GlState::bindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<long> (size), nullptr, GL_DYNAMIC_DRAW);
+
+    // Also binds the buffer to the generic GL_UNIFORM_BUFFER point, which the state cache already expects
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, buffer);
+
+    return {buffer, bindingPoint, size};
+}
+
+void UniformBuffer::update(const void *data, size_t dataSize, size_t offset) const {
+    if (id == 0) {
+        return;
+    }
+    if (offset + dataSize > size) {
+        cout << "Uniform buffer update out of range!" << endl;
+        return;
+    }
+
+    GlState::bindBuffer(GL_UNIFORM_BUFFER, id);
+    glBufferSubData(GL_UNIFORM_BUFFER, static_cast<long> (offset), static_cast<long> (dataSize), data);
+}
+
+unsigned int UniformBuffer::getBindingPoint() const {
+    return bindingPoint;
+}
+
+unsigned int submitShader(unsigned int type, const string &source) {
+    unsigned int id = glCreateShader(type);
+    const char *src = source.c_str();
+    glShaderSource(id, 1, &src, nullptr);
+    glCompileShader(id);
+    return id;
+}
+
+PendingShaderProgram::PendingShaderProgram(unsigned int inputProgram, unsigned int inputVertexShader,
+                                           unsigned int inputFragmentShader, std::string inputBinaryPath)
+        : program(inputProgram), vertexShader(inputVertexShader), fragmentShader(inputFragmentShader),
+          binaryPath(std::move(inputBinaryPath)), linkStatus(inputVertexShader == 0 ? GL_TRUE : GL_FALSE) {}
+
+PendingShaderProgram::PendingShaderProgram(PendingShaderProgram &&other) noexcept
+        : program(other.program), vertexShader(other.vertexShader), fragmentShader(other.fragmentShader),
+          binaryPath(std::move(other.binaryPath)), linkStatus(other.linkStatus) {
+    other.program = 0;
+    other.vertexShader = 0;
+    other.fragmentShader = 0;
+}
+
+PendingShaderProgram::~PendingShaderProgram() {
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    glDeleteProgram(program);
+}
+
+PendingShaderProgram PendingShaderProgram::submit(const std::string &vertexShader, const std::string &fragmentShader) {
+    static bool compilerThreadsRequested = false;
+    if (GLEW_KHR_parallel_shader_compile && !compilerThreadsRequested) {
+        // Let the driver pick as many compiler threads as it wants
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        compilerThreadsRequested = true;
+    }
+
+    string binaryPath;
+    if (isProgramBinaryCacheSupported()) {
+        filesystem::path path = getProgramBinaryPath(vertexShader, fragmentShader);
+        if (unsigned int cachedProgram = loadProgramBinary(path); cachedProgram != 0) {
+            return {cachedProgram, 0, 0, ""};
+        }
+        binaryPath = path.string();
+    }
+
+    // No status queries here: any of them would wait for the compiler and serialize the programs
+    unsigned int program = glCreateProgram();
+    unsigned int vs = submitShader(GL_VERTEX_SHADER, vertexShader);
+    unsigned int fs = submitShader(GL_FRAGMENT_SHADER, fragmentShader);
+
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    if (!binaryPath.empty()) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(program);
+
+    return {program, vs, fs, binaryPath};
+}
+
+bool PendingShaderProgram::isReady() const {
+    if (program == 0 || !GLEW_KHR_parallel_shader_compile) {
+        return true;
+    }
+
+    int completed;
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+bool PendingShaderProgram::isLinked() {
+    if (vertexShader != 0) {
+        ShaderUtils::IsShaderCompiled(vertexShader, GL_VERTEX_SHADER);
+        ShaderUtils::IsShaderCompiled(fragmentShader, GL_FRAGMENT_SHADER);
+
+        glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+        if (linkStatus == GL_FALSE) {
+            int length;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+            auto message = (char *) alloca(length * sizeof(char));
+            glGetProgramInfoLog(program, length, &length, message);
+            cout << "Failed to link shader program!" << endl;
+            cout << message << endl;
+        } else if (!binaryPath.empty()) {
+            saveProgramBinary(program, binaryPath);
+        }
+
+        glDetachShader(program, vertexShader);
+        glDetachShader(program, fragmentShader);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        vertexShader = 0;
+        fragmentShader = 0;
+    }
+
+    return linkStatus == GL_TRUE;
+}
+
+ShaderProgram PendingShaderProgram::get() {
+    if (!isLinked()) {
+        glDeleteProgram(release());
+        return ShaderProgram(0);
+    }
+    return ShaderProgram(release());
+}
+
+unsigned int PendingShaderProgram::release() {
+    unsigned int readyProgram = program;
+    program = 0;
+    return readyProgram;
+}
+
+PendingShaderProgram
+ShaderProgram::compileAsync(const std::string &vertexShader, const std::string &fragmentShader) {
+    return PendingShaderProgram::submit(vertexShader, fragmentShader);
+}
+
+PendingShaderProgram
+ShaderProgram::compileAsyncFromFiles(const std::string &vertexShaderFilePath,
+                                     const std::string &fragmentShaderFilePath) {
+    return PendingShaderProgram::submit(readFromFile(vertexShaderFilePath), readFromFile(fragmentShaderFilePath));
+}
+
+ShaderProgram::ShaderProgram(const unsigned int &inputId) : id(inputId) {
+    if (id == 0) {
+        return;
+    }
+    cacheUniformLocations();
+    bindUniformBlocks();
+}
+
+void ShaderProgram::bindUniformBlocks() {
+    int blockCount = 0;
+    int maxNameLength = 0;
+    glGetProgramiv(id, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+    glGetProgramiv(id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+
+    vector<char> nameBuffer(maxNameLength + 1);
+    for (int i = 0; i < blockCount; i++) {
+        int nameLength = 0;
+        glGetActiveUniformBlockName(id, i, static_cast<int>(nameBuffer.size()), &nameLength, nameBuffer.data());
+        string blockName(nameBuffer.data(), nameLength);
+        unsigned int bindingPoint = 0;
+        if (UniformBlockBindings::getBindingPoint(blockName, bindingPoint)) {
+            glUniformBlockBinding(id, i, bindingPoint);
+        }
+    }
+}
+
+void ShaderProgram::cacheUniformLocations() {
+    uniformLocations.clear();
+
+    int uniformCount = 0;
+    int maxNameLength = 0;
+    glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    vector<char> nameBuffer(maxNameLength + 1);
+    for (int i = 0; i < uniformCount; i++) {
+        int nameLength = 0;
+        int size = 0;
+        unsigned int type = 0;
+        glGetActiveUniform(id, i, static_cast<int>(nameBuffer.size()), &nameLength, &size, &type, nameBuffer.data());
+
+        // Uniform block members have no location
+        int location = glGetUniformLocation(id, nameBuffer.data());
+        if (location < 0) {
+            continue;
+        }
+
+        string name(nameBuffer.data(), nameLength);
+        uniformLocations.insert(name, location);
+
+        // Arrays are reported as "name[0]", but are usually set by their plain name
+        if (size_t bracket = name.find("[0]"); bracket != string::npos && bracket + 3 == name.size()) {
+            uniformLocations.insert(name.substr(0, bracket), location);
+        }
+    }
+}
+
+bool ShaderProgram::reloadFrom(PendingShaderProgram &pending) {
+    if (!pending.isLinked()) {
+        return false;
+    }
+
+    unsigned int previousId = id;
+    id = pending.release();
+
+    // Asking GL for the current program would stall the pipeline; the tracker already knows it
+    if (GlState::getProgram() == previousId) {
+        GlState::useProgram(id);
+    }
+    glDeleteProgram(previousId);
+    GlState::onProgramDeleted(previousId);
+
+    cacheUniformLocations();
+    bindUniformBlocks();
+    return true;
+}
+
+int ShaderProgram::getUniformLocation(const std::string &name) const {
+    return uniformLocations.find(name.c_str(), name.size(), hashUniformName(name.c_str(), name.size()));
+}
+
+int ShaderProgram::getUniformLocation(UniformHandle handle) const {
+    return uniformLocations.find(handle.name, handle.length, handle.hash);
+}
+
+ShaderProgram::ShaderProgram(ShaderProgram &&other) noexcept
+        : id(other.id), uniformLocations(std::move(other.uniformLocations)) {
+    other.id = 0;
+    other.uniformLocations.clear();
+}
+
+ShaderProgram &ShaderProgram::operator=(ShaderProgram &&other) noexcept {
+    if (this != &other) {
+        if (id != 0) {
+            glDeleteProgram(id);
+            GlState::onProgramDeleted(id);
+        }
+        id = other.id;
+        uniformLocations = std::move(other.uniformLocations);
+        other.id = 0;
+        other.uniformLocations.clear();
+    }
+    return *this;
+}
 
 ShaderProgram::~ShaderProgram() {
-    glDeleteProgram(id);
+    if (id != 0) {
+        glDeleteProgram(id);
+        GlState::onProgramDeleted(id);
+    }
 }
 
 void ShaderProgram::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(id, name.c_str()), (int) value);
+    glUniform1i(getUniformLocation(name), (int) value);
 }
 
 void ShaderProgram::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(id, name.c_str()), value);
+    glUniform1i(getUniformLocation(name), value);
 }
 
 void ShaderProgram::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(id, name.c_str()), value);
+    glUniform1f(getUniformLocation(name), value);
 }
 
 void ShaderProgram::setVec2(const std::string &name, const glm::vec2 &value) const {
-    glUniform2fv(glGetUniformLocation(id, name.c_str()), 1, &value[0]);
+    glUniform2fv(getUniformLocation(name), 1, &value[0]);
 }
 
 void ShaderProgram::setVec2(const std::string &name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(id, name.c_str()), x, y);
+    glUniform2f(getUniformLocation(name), x, y);
 }
 
 void ShaderProgram::setVec3(const std::string &name, const glm::vec3 &value) const {
-    glUniform3fv(glGetUniformLocation(id, name.c_str()), 1, &value[0]);
+    glUniform3fv(getUniformLocation(name), 1, &value[0]);
 }
 
 void ShaderProgram::setVec3(const std::string &name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(id, name.c_str()), x, y, z);
+    glUniform3f(getUniformLocation(name), x, y, z);
 }
 
 void ShaderProgram::setVec4(const std::string &name, const glm::vec4 &value) const {
-    glUniform4fv(glGetUniformLocation(id, name.c_str()), 1, &value[0]);
+    glUniform4fv(getUniformLocation(name), 1, &value[0]);
 }
 
 void ShaderProgram::setVec4(const std::string &name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(id, name.c_str()), x, y, z, w);
+    glUniform4f(getUniformLocation(name), x, y, z, w);
 }
 
 void ShaderProgram::setMat2(const std::string &name, const glm::mat2 &mat) const {
-    glUniformMatrix2fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void ShaderProgram::setMat3(const std::string &name, const glm::mat3 &mat) const {
-    glUniformMatrix3fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void ShaderProgram::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+}
+
+void ShaderProgram::setBool(UniformHandle handle, bool value) const {
+    glUniform1i(getUniformLocation(handle), (int) value);
+}
+
+void ShaderProgram::setInt(UniformHandle handle, int value) const {
+    glUniform1i(getUniformLocation(handle), value);
+}
+
+void ShaderProgram::setFloat(UniformHandle handle, float value) const {
+    glUniform1f(getUniformLocation(handle), value);
+}
+
+void ShaderProgram::setVec2(UniformHandle handle, const glm::vec2 &value) const {
+    glUniform2fv(getUniformLocation(handle), 1, &value[0]);
+}
+
+void ShaderProgram::setVec2(UniformHandle handle, float x, float y) const {
+    glUniform2f(getUniformLocation(handle), x, y);
+}
+
+void ShaderProgram::setVec3(UniformHandle handle, const glm::vec3 &value) const {
+    glUniform3fv(getUniformLocation(handle), 1, &value[0]);
+}
+
+void ShaderProgram::setVec3(UniformHandle handle, float x, float y, float z) const {
+    glUniform3f(getUniformLocation(handle), x, y, z);
+}
+
+void ShaderProgram::setVec4(UniformHandle handle, const glm::vec4 &value) const {
+    glUniform4fv(getUniformLocation(handle), 1, &value[0]);
+}
+
+void ShaderProgram::setVec4(UniformHandle handle, float x, float y, float z, float w) const {
+    glUniform4f(getUniformLocation(handle), x, y, z, w);
+}
+
+void ShaderProgram::setMat2(UniformHandle handle, const glm::mat2 &mat) const {
+    glUniformMatrix2fv(getUniformLocation(handle), 1, GL_FALSE, &mat[0][0]);
+}
+
+void ShaderProgram::setMat3(UniformHandle handle, const glm::mat3 &mat) const {
+    glUniformMatrix3fv(getUniformLocation(handle), 1, GL_FALSE, &mat[0][0]);
+}
+
+void ShaderProgram::setMat4(UniformHandle handle, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(getUniformLocation(handle), 1, GL_FALSE, &mat[0][0]);
 }
 
 void ShaderProgram::use() {
-    glUseProgram(id);
+    GlState::useProgram(id);
 }
 
 unsigned int ShaderProgram::getShaderProgramId() {
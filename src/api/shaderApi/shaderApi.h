@@ -1,6 +1,10 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -9,15 +13,194 @@ class ShaderUtils {
 public:
     static unsigned int CompileShader(unsigned int type, const std::string &source);
 
+    // Checks the compile status and prints the info log on failure
+    static bool IsShaderCompiled(unsigned int id, unsigned int type);
+
     static unsigned int CreateShader(const std::string &vertexShader, const std::string &fragmentShader);
 
     static unsigned int
     CreateShaderFromFiles(const std::string &vertexShaderFilePath, const std::string &fragmentShaderFilePath);
+
+    // Directory of the linked program binaries reused by CreateShader. Defaults to $SHADER_CACHE_DIR or
+    // <tmp>/graphicsLabsShaderCache; an empty path disables the cache.
+    static void SetProgramBinaryCacheDirectory(const std::string &directory);
+
+    static std::string GetProgramBinaryCacheDirectory();
+};
+
+// FNV-1a hash of a uniform name. Picks the slot in the uniform location table; the name itself decides the match.
+constexpr uint32_t hashUniformName(const char *name, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Pre-hashed uniform name. Built from a literal ("model"_u) it is hashed at compile time, so the setters
+// taking a handle neither allocate a std::string nor hash anything at runtime. The literal is kept for the
+// name comparison on lookup.
+struct UniformHandle {
+    const char *name;
+    size_t length;
+    uint32_t hash;
+
+    constexpr UniformHandle(const char *inputName, size_t inputLength)
+            : name(inputName), length(inputLength), hash(hashUniformName(inputName, inputLength)) {}
+};
+
+constexpr UniformHandle operator ""_u(const char *name, size_t length) {
+    return {name, length};
+}
+
+// Flat open-addressing table: uniform name -> location. Filled once after linking, so the setters never
+// have to ask the driver for a location on the hot path. Names whose hashes collide get slots of their own.
+class UniformLocationTable {
+public:
+    void insert(const std::string &name, int location);
+
+    int find(const char *name, size_t length, uint32_t hash) const;
+
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct Slot {
+        uint32_t hash;
+        int location;
+        std::string name;
+
+        bool matches(const char *otherName, size_t length, uint32_t otherHash) const {
+            return hash == otherHash && name.size() == length && memcmp(name.data(), otherName, length) == 0;
+        }
+    };
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+
+    void grow();
 };
 
+// std140 layout of the shared camera block:
+// layout(std140) uniform Camera { mat4 projection; mat4 view; vec3 viewPos; };
+struct CameraBlock {
+    glm::mat4 projection;
+    glm::mat4 view;
+    alignas(16) glm::vec3 viewPos;
+};
+static_assert(sizeof(CameraBlock) == 144, "CameraBlock must match the std140 layout");
+
+// std140 layout of the shared light block:
+// layout(std140) uniform Light { vec3 lightPos; vec3 lightColor; };
+struct LightBlock {
+    alignas(16) glm::vec3 lightPos;
+    alignas(16) glm::vec3 lightColor;
+};
+static_assert(sizeof(LightBlock) == 32, "LightBlock must match the std140 layout");
+
+// Assigns every uniform block name a fixed binding point, shared by all programs and buffers.
+class UniformBlockBindings {
+public:
+    // False, after printing the block name, once all GL_MAX_UNIFORM_BUFFER_BINDINGS points are taken
+    static bool getBindingPoint(const std::string &blockName, unsigned int &bindingPoint);
+
+private:
+    static std::unordered_map<std::string, unsigned int> &getBindingPoints();
+};
+
+// Uniform buffer bound to the binding point of its block. Written once per frame, read by every program
+// that declares the block. Owns the GL buffer, so it can be moved but not copied.
+class UniformBuffer {
+public:
+
+    UniformBuffer(UniformBuffer &&other) noexcept;
+
+    UniformBuffer &operator=(UniformBuffer &&other) noexcept;
+
+    UniformBuffer(const UniformBuffer &) = delete;
+
+    UniformBuffer &operator=(const UniformBuffer &) = delete;
+
+    ~UniformBuffer();
+
+    // Without a free binding point the buffer is empty and update() does nothing
+    static UniformBuffer create(const std::string &blockName, size_t size);
+
+    void update(const void *data, size_t dataSize, size_t offset = 0) const;
+
+    template<class Block>
+    void update(const Block &block) const {
+        update(&block, sizeof(Block));
+    }
+
+    unsigned int getBindingPoint() const;
+
+private:
+    unsigned int id;
+    unsigned int bindingPoint;
+    size_t size;
+
+    UniformBuffer(unsigned int inputId, unsigned int inputBindingPoint, size_t inputSize);
+};
+
+class ShaderProgram;
+
+// Program whose compile and link have been submitted to the driver but not checked yet. Submitting every
+// program up front lets the driver compile them in parallel (GL_KHR_parallel_shader_compile) while the
+// render loop keeps drawing; get() is the first point that may wait for the compiler.
+class PendingShaderProgram {
+public:
+
+    PendingShaderProgram(PendingShaderProgram &&other) noexcept;
+
+    PendingShaderProgram(const PendingShaderProgram &) = delete;
+
+    PendingShaderProgram &operator=(const PendingShaderProgram &) = delete;
+
+    ~PendingShaderProgram();
+
+    // Never blocks. Without GL_KHR_parallel_shader_compile there is nothing to poll, so it is always true
+    bool isReady() const;
+
+    // Waits for the compiler if needed, prints the info logs and reports whether the program linked
+    bool isLinked();
+
+    // Checks compile/link status and hands the program over. Call once. A program that failed to compile or
+    // link is deleted and an empty one, with getShaderProgramId() == 0, is returned instead.
+    ShaderProgram get();
+
+private:
+    unsigned int program;
+    unsigned int vertexShader;
+    unsigned int fragmentShader;
+    std::string binaryPath;
+    int linkStatus;
+
+    PendingShaderProgram(unsigned int inputProgram, unsigned int inputVertexShader,
+                         unsigned int inputFragmentShader, std::string inputBinaryPath);
+
+    static PendingShaderProgram submit(const std::string &vertexShader, const std::string &fragmentShader);
+
+    unsigned int release();
+
+    friend class ShaderProgram;
+};
+
+// Owns the GL program, so it can be moved but not copied. ShaderPermutationCache and ShaderWatcher keep
+// pointers to programs, which therefore must not be moved while they are registered there.
 class ShaderProgram {
 public:
 
+    ShaderProgram(ShaderProgram &&other) noexcept;
+
+    ShaderProgram &operator=(ShaderProgram &&other) noexcept;
+
+    ShaderProgram(const ShaderProgram &) = delete;
+
+    ShaderProgram &operator=(const ShaderProgram &) = delete;
+
     ~ShaderProgram();
 
     static ShaderProgram
@@ -26,6 +209,11 @@ public:
     static ShaderProgram
     createShaderProgramFromStrings(const std::string &vertexShader, const std::string &fragmentShader);
 
+    static PendingShaderProgram compileAsync(const std::string &vertexShader, const std::string &fragmentShader);
+
+    static PendingShaderProgram
+    compileAsyncFromFiles(const std::string &vertexShaderFilePath, const std::string &fragmentShaderFilePath);
+
     void use();
 
     void setBool(const std::string &name, bool value) const;
@@ -52,11 +240,50 @@ public:
 
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
 
+    void setBool(UniformHandle handle, bool value) const;
+
+    void setInt(UniformHandle handle, int value) const;
+
+    void setFloat(UniformHandle handle, float value) const;
+
+    void setVec2(UniformHandle handle, const glm::vec2 &value) const;
+
+    void setVec2(UniformHandle handle, float x, float y) const;
+
+    void setVec3(UniformHandle handle, const glm::vec3 &value) const;
+
+    void setVec3(UniformHandle handle, float x, float y, float z) const;
+
+    void setVec4(UniformHandle handle, const glm::vec4 &value) const;
+
+    void setVec4(UniformHandle handle, float x, float y, float z, float w) const;
+
+    void setMat2(UniformHandle handle, const glm::mat2 &mat) const;
+
+    void setMat3(UniformHandle handle, const glm::mat3 &mat) const;
+
+    void setMat4(UniformHandle handle, const glm::mat4 &mat) const;
+
     unsigned int getShaderProgramId();
 
+    // Swaps in a freshly linked program and rebuilds the uniform cache. On a failed compile or link the
+    // current program is kept and false is returned.
+    bool reloadFrom(PendingShaderProgram &pending);
+
+    int getUniformLocation(const std::string &name) const;
+
+    int getUniformLocation(UniformHandle handle) const;
+
 private:
     unsigned int id;
+    UniformLocationTable uniformLocations;
 
     explicit ShaderProgram(const unsigned int &inputId);
+
+    void cacheUniformLocations();
+
+    void bindUniformBlocks();
+
+    friend class PendingShaderProgram;
 };
 
@@ -0,0 +1,145 @@
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "contextApi.h"
+#include "shaderApi.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+const int ITERATIONS = 200000;
+const int STARTUP_PROGRAMS = 32;
+
+// Same uniform set as the Phong scenes (specular.cpp, planet.cpp)
+const string VERTEX_SHADER = R"glsl(
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+
+out vec3 Normal;
+out vec3 FragPos;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main(){
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+}
+)glsl";
+
+const string FRAGMENT_SHADER = R"glsl(
+#version 330 core
+
+in vec3 Normal;
+in vec3 FragPos;
+
+out vec4 FragColor;
+
+uniform vec3 objectColor;
+uniform vec3 lightColor;
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+
+void main() {
+    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    float diff = max(dot(normalize(Normal), lightDir), 0.0);
+    float spec = pow(max(dot(viewDir, reflect(-lightDir, normalize(Normal))), 0.0), 32);
+    FragColor = vec4((0.1 + diff + 0.5 * spec) * lightColor * objectColor, 1.0);
+}
+)glsl";
+
+template<class Body>
+double measureNanosPerIteration(Body body) {
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        body();
+    }
+    glFinish();
+    auto end = chrono::steady_clock::now();
+    return static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / ITERATIONS;
+}
+
+// Creates STARTUP_PROGRAMS distinct programs, like a scene with dozens of materials
+double measureStartupMillis() {
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < STARTUP_PROGRAMS; i++) {
+        string fragmentShader = FRAGMENT_SHADER + "// variant " + to_string(i) + "\n";
+        unsigned int program = ShaderUtils::CreateShader(VERTEX_SHADER, fragmentShader);
+        glDeleteProgram(program);
+    }
+    glFinish();
+    auto end = chrono::steady_clock::now();
+    return static_cast<double>(chrono::duration_cast<chrono::microseconds>(end - start).count()) / 1000.0;
+}
+
+// Run with --headless or LIBGL_ALWAYS_SOFTWARE=1 to measure under Mesa llvmpipe
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, 64, 64, "Shader Api Benchmark");
+    if (!context.isCreated()) {
+        return -1;
+    }
+
+    filesystem::path cacheDirectory = filesystem::temp_directory_path() / "shaderApiBenchmarkCache";
+    filesystem::remove_all(cacheDirectory);
+
+    ShaderUtils::SetProgramBinaryCacheDirectory("");
+    double uncachedStartup = measureStartupMillis();
+    ShaderUtils::SetProgramBinaryCacheDirectory(cacheDirectory.string());
+    double coldStartup = measureStartupMillis();
+    double warmStartup = measureStartupMillis();
+    filesystem::remove_all(cacheDirectory);
+
+    ShaderProgram program = ShaderProgram::createShaderProgramFromStrings(VERTEX_SHADER, FRAGMENT_SHADER);
+    program.use();
+    unsigned int programId = program.getShaderProgramId();
+
+    auto model = glm::mat4(1.0f);
+    auto position = glm::vec3(1.0f, 2.0f, 3.0f);
+
+    double driverLookup = measureNanosPerIteration([&]() {
+        glUniformMatrix4fv(glGetUniformLocation(programId, "model"), 1, GL_FALSE, &model[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(programId, "view"), 1, GL_FALSE, &model[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(programId, "projection"), 1, GL_FALSE, &model[0][0]);
+        glUniform3fv(glGetUniformLocation(programId, "objectColor"), 1, &position[0]);
+        glUniform3fv(glGetUniformLocation(programId, "lightColor"), 1, &position[0]);
+        glUniform3fv(glGetUniformLocation(programId, "lightPos"), 1, &position[0]);
+        glUniform3fv(glGetUniformLocation(programId, "viewPos"), 1, &position[0]);
+    });
+
+    double cachedLookup = measureNanosPerIteration([&]() {
+        program.setMat4("model", model);
+        program.setMat4("view", model);
+        program.setMat4("projection", model);
+        program.setVec3("objectColor", position);
+        program.setVec3("lightColor", position);
+        program.setVec3("lightPos", position);
+        program.setVec3("viewPos", position);
+    });
+
+    double handleLookup = measureNanosPerIteration([&]() {
+        program.setMat4("model"_u, model);
+        program.setMat4("view"_u, model);
+        program.setMat4("projection"_u, model);
+        program.setVec3("objectColor"_u, position);
+        program.setVec3("lightColor"_u, position);
+        program.setVec3("lightPos"_u, position);
+        program.setVec3("viewPos"_u, position);
+    });
+
+    cout << "Renderer: " << glGetString(GL_RENDERER) << endl;
+    cout << STARTUP_PROGRAMS << " programs without binary cache: " << uncachedStartup << " ms" << endl;
+    cout << STARTUP_PROGRAMS << " programs, cold binary cache:   " << coldStartup << " ms" << endl;
+    cout << STARTUP_PROGRAMS << " programs, warm binary cache:   " << warmStartup << " ms" << endl;
+    cout << "7 uniforms via glGetUniformLocation: " << driverLookup << " ns/frame" << endl;
+    cout << "7 uniforms via cached locations:     " << cachedLookup << " ns/frame" << endl;
+    cout << "7 uniforms via compile-time handles: " << handleLookup << " ns/frame" << endl;
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "shaderPreprocessor.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+using namespace std;
+
+struct PreprocessorState {
+    set<string> includedFiles;
+    int sourceStringCount = 0;
+};
+
+string readShaderFile(const string &filePath, bool &found) {
+    std::stringstream buffer;
+    ifstream file(filePath);
+    found = file.is_open();
+    if (found) {
+        buffer << file.rdbuf();
+    }
+    return buffer.str();
+}
+
+// Returns the quoted file name of an #include directive, or an empty string for any other line
+string parseInclude(const string &line) {
+    size_t start = line.find_first_not_of(" \t");
+    if (start == string::npos || line.compare(start, 8, "#include") != 0) {
+        return "";
+    }
+
+    size_t open = line.find('"', start + 8);
+    size_t close = open == string::npos ? string::npos : line.find('"', open + 1);
+    if (close == string::npos) {
+        return "";
+    }
+    return line.substr(open + 1, close - open - 1);
+}
+
+bool isVersionDirective(const string &line) {
+    size_t start = line.find_first_not_of(" \t");
+    return start != string::npos && line.compare(start, 8, "#version") == 0;
+}
+
+void expandIncludes(const string &source, const filesystem::path &directory, int sourceString, int firstLineNumber,
+                    PreprocessorState &state, std::stringstream &output) {
+    std::stringstream input(source);
+    string line;
+    int lineNumber = firstLineNumber - 1;
+
+    while (getline(input, line)) {
+        lineNumber++;
+
+        string includeName = parseInclude(line);
+        if (includeName.empty()) {
+            output << line << '\n';
+            continue;
+        }
+
+        filesystem::path includePath = (directory / includeName).lexically_normal();
+        if (state.includedFiles.insert(includePath.string()).second) {
+            bool found;
+            string includeSource = readShaderFile(includePath.string(), found);
+            if (!found) {
+                cout << "Failed to include shader file! Path: " << includePath.string() << endl;
+            }
+
+            // #line keeps the compiler's error messages pointing at the right file and line
+            int includeSourceString = ++state.sourceStringCount;
+            output << "#line 1 " << includeSourceString << '\n';
+            expandIncludes(includeSource, includePath.parent_path(), includeSourceString, 1, state, output);
+        }
+        output << "#line " << lineNumber + 1 << ' ' << sourceString << '\n';
+    }
+}
+
+string ShaderPreprocessor::process(const string &source, const ShaderDefines &defines,
+                                   const string &includeDirectory, vector<string> *includedFiles) {
+    std::stringstream output;
+
+    // #version has to stay the first directive, so the defines go right after it
+    size_t bodyStart = 0;
+    int bodyLineNumber = 1;
+    for (size_t lineStart = 0; lineStart < source.size();) {
+        size_t lineEnd = source.find('\n', lineStart);
+        lineEnd = lineEnd == string::npos ? source.size() : lineEnd + 1;
+        if (isVersionDirective(source.substr(lineStart, lineEnd - lineStart))) {
+            output << source.substr(0, lineEnd);
+            if (lineEnd == source.size() && source.back() != '\n') {
+                output << '\n';
+            }
+            bodyStart = lineEnd;
+            bodyLineNumber = 1 + static_cast<int>(count(source.begin(), source.begin() + lineEnd, '\n'));
+            break;
+        }
+        lineStart = lineEnd;
+    }
+
+    for (const auto &define: defines) {
+        output << "#define " << define.first;
+        if (!define.second.empty()) {
+            output << ' ' << define.second;
+        }
+        output << '\n';
+    }
+    if (!defines.empty()) {
+        output << "#line " << bodyLineNumber << " 0\n";
+    }
+
+    PreprocessorState state;
+    expandIncludes(source.substr(bodyStart), filesystem::path(includeDirectory), 0, bodyLineNumber, state, output);
+
+    if (includedFiles) {
+        includedFiles->assign(state.includedFiles.begin(), state.includedFiles.end());
+    }
+    return output.str();
+}
+
+string ShaderPreprocessor::processFile(const string &filePath, const ShaderDefines &defines,
+                                       vector<string> *includedFiles) {
+    bool found;
+    string source = readShaderFile(filePath, found);
+    if (!found) {
+        cout << "Failed to read shader file! Path: " << filePath << endl;
+    }
+    return process(source, defines, filesystem::path(filePath).parent_path().string(), includedFiles);
+}
+
+ShaderProgram &ShaderPermutationCache::get(const string &vertexShaderFilePath, const string &fragmentShaderFilePath,
+                                           const ShaderDefines &defines) {
+    string key = vertexShaderFilePath + '\n' + fragmentShaderFilePath + '\n';
+    for (const auto &define: defines) {
+        key += define.first + '=' + define.second + ';';
+    }
+
+    auto cached = programs.find(key);
+    if (cached != programs.end()) {
+        return *cached->second;
+    }
+
+    string vertexShader = ShaderPreprocessor::processFile(vertexShaderFilePath, defines);
+    string fragmentShader = ShaderPreprocessor::processFile(fragmentShaderFilePath, defines);
+    auto program = unique_ptr<ShaderProgram>(
+            new ShaderProgram(ShaderProgram::createShaderProgramFromStrings(vertexShader, fragmentShader)));
+    return *programs.emplace(key, std::move(program)).first->second;
+}
+
+size_t ShaderPermutationCache::size() const {
+    return programs.size();
+}
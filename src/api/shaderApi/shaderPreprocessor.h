@@ -0,0 +1,34 @@
+#pragma once
+
+#include "shaderApi.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// NAME -> value, injected as "#define NAME value" right after #version. An empty value defines a flag.
+// Ordered, so equal define sets always produce the same source and the same cache key.
+using ShaderDefines = std::map<std::string, std::string>;
+
+// Resolves #include "file" (relative to the including file, each file at most once) and injects defines.
+class ShaderPreprocessor {
+public:
+    static std::string process(const std::string &source, const ShaderDefines &defines,
+                               const std::string &includeDirectory, std::vector<std::string> *includedFiles = nullptr);
+
+    static std::string processFile(const std::string &filePath, const ShaderDefines &defines,
+                                   std::vector<std::string> *includedFiles = nullptr);
+};
+
+// Builds every variant of an uber-shader exactly once per unique define set and shares it afterwards.
+class ShaderPermutationCache {
+public:
+    ShaderProgram &get(const std::string &vertexShaderFilePath, const std::string &fragmentShaderFilePath,
+                       const ShaderDefines &defines = {});
+
+    size_t size() const;
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<ShaderProgram>> programs;
+};
@@ -0,0 +1,192 @@
+#include "shaderWatcher.h"
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+using namespace std;
+
+string normalizePath(const string &filePath) {
+    error_code error;
+    filesystem::path absolutePath = filesystem::absolute(filePath, error);
+    return (error ? filesystem::path(filePath) : absolutePath).lexically_normal().string();
+}
+
+ShaderWatcher::ShaderWatcher() : inotifyDescriptor(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)), running(true) {
+    if (inotifyDescriptor < 0) {
+        cout << "Failed to start shader watcher!" << endl;
+        running = false;
+        return;
+    }
+    watcherThread = thread(&ShaderWatcher::watchLoop, this);
+}
+
+ShaderWatcher::~ShaderWatcher() {
+    running = false;
+    if (watcherThread.joinable()) {
+        watcherThread.join();
+    }
+    if (inotifyDescriptor >= 0) {
+        close(inotifyDescriptor);
+    }
+}
+
+void ShaderWatcher::watch(ShaderProgram &program, const string &vertexShaderFilePath,
+                          const string &fragmentShaderFilePath, const ShaderDefines &defines) {
+    WatchedProgram watchedProgram{&program, normalizePath(vertexShaderFilePath),
+                                  normalizePath(fragmentShaderFilePath), defines, {}, nullopt, nullopt};
+
+    // Only read to learn the included files; the program itself is already built
+    watchedProgram.includedFiles = readSources(watchedProgram.vertexShaderFilePath,
+                                               watchedProgram.fragmentShaderFilePath, defines).includedFiles;
+
+    lock_guard<mutex> lock(watchedProgramsMutex);
+    watchDirectory(watchedProgram.vertexShaderFilePath);
+    watchDirectory(watchedProgram.fragmentShaderFilePath);
+    for (const string &includedFile: watchedProgram.includedFiles) {
+        watchDirectory(includedFile);
+    }
+    watchedPrograms.push_back(std::move(watchedProgram));
+}
+
+ShaderWatcher::ShaderSources ShaderWatcher::readSources(const string &vertexShaderFilePath,
+                                                        const string &fragmentShaderFilePath,
+                                                        const ShaderDefines &defines) {
+    vector<string> vertexIncludes;
+    vector<string> fragmentIncludes;
+    ShaderSources sources;
+    sources.vertexShader = ShaderPreprocessor::processFile(vertexShaderFilePath, defines, &vertexIncludes);
+    sources.fragmentShader = ShaderPreprocessor::processFile(fragmentShaderFilePath, defines, &fragmentIncludes);
+
+    for (const string &includedFile: vertexIncludes) {
+        sources.includedFiles.push_back(normalizePath(includedFile));
+    }
+    for (const string &includedFile: fragmentIncludes) {
+        sources.includedFiles.push_back(normalizePath(includedFile));
+    }
+    return sources;
+}
+
+// Directories rather than files are watched: editors usually save by writing a new file and renaming it
+// over the old one, which would silently end a watch on the old inode.
+void ShaderWatcher::watchDirectory(const string &filePath) {
+    if (inotifyDescriptor < 0) {
+        return;
+    }
+
+    string directory = filesystem::path(normalizePath(filePath)).parent_path().string();
+    for (const auto &watchedDirectory: watchedDirectories) {
+        if (watchedDirectory.second == directory) {
+            return;
+        }
+    }
+
+    int watchDescriptor = inotify_add_watch(inotifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watchDescriptor < 0) {
+        cout << "Failed to watch shader directory! Path: " << directory << endl;
+        return;
+    }
+    watchedDirectories[watchDescriptor] = directory;
+}
+
+void ShaderWatcher::watchLoop() {
+    alignas(inotify_event) char buffer[4096];
+    pollfd descriptor{inotifyDescriptor, POLLIN, 0};
+
+    while (running) {
+        if (poll(&descriptor, 1, 100) <= 0) {
+            continue;
+        }
+
+        ssize_t length;
+        while ((length = read(inotifyDescriptor, buffer, sizeof(buffer))) > 0) {
+            for (char *pointer = buffer; pointer < buffer + length;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(pointer);
+                pointer += sizeof(inotify_event) + event->len;
+                if (event->len == 0) {
+                    continue;
+                }
+
+                string directory;
+                {
+                    lock_guard<mutex> lock(watchedProgramsMutex);
+                    if (auto watchedDirectory = watchedDirectories.find(event->wd);
+                            watchedDirectory != watchedDirectories.end()) {
+                        directory = watchedDirectory->second;
+                    }
+                }
+                if (!directory.empty()) {
+                    onFileChanged((filesystem::path(directory) / event->name).string());
+                }
+            }
+        }
+    }
+}
+
+// The files are read outside the lock, so update() on the GL thread never waits for the disk. Programs are
+// only ever appended, which keeps the indices valid between the two locked sections.
+void ShaderWatcher::onFileChanged(const string &filePath) {
+    struct ChangedProgram {
+        size_t index;
+        string vertexShaderFilePath;
+        string fragmentShaderFilePath;
+        ShaderDefines defines;
+    };
+
+    vector<ChangedProgram> changedPrograms;
+    {
+        lock_guard<mutex> lock(watchedProgramsMutex);
+        for (size_t i = 0; i < watchedPrograms.size(); i++) {
+            const WatchedProgram &watchedProgram = watchedPrograms[i];
+            bool isDependency = watchedProgram.vertexShaderFilePath == filePath ||
+                                watchedProgram.fragmentShaderFilePath == filePath ||
+                                find(watchedProgram.includedFiles.begin(), watchedProgram.includedFiles.end(),
+                                     filePath) != watchedProgram.includedFiles.end();
+            if (isDependency) {
+                changedPrograms.push_back({i, watchedProgram.vertexShaderFilePath,
+                                           watchedProgram.fragmentShaderFilePath, watchedProgram.defines});
+            }
+        }
+    }
+
+    for (const ChangedProgram &changedProgram: changedPrograms) {
+        ShaderSources sources = readSources(changedProgram.vertexShaderFilePath,
+                                            changedProgram.fragmentShaderFilePath, changedProgram.defines);
+
+        lock_guard<mutex> lock(watchedProgramsMutex);
+        WatchedProgram &watchedProgram = watchedPrograms[changedProgram.index];
+        // An edit can add an include from a directory that is not watched yet
+        for (const string &includedFile: sources.includedFiles) {
+            watchDirectory(includedFile);
+        }
+        watchedProgram.includedFiles = std::move(sources.includedFiles);
+        watchedProgram.changedSources = make_pair(std::move(sources.vertexShader), std::move(sources.fragmentShader));
+    }
+}
+
+void ShaderWatcher::update() {
+    lock_guard<mutex> lock(watchedProgramsMutex);
+    for (WatchedProgram &watchedProgram: watchedPrograms) {
+        // A newer save supersedes a compile that is still in flight
+        if (watchedProgram.changedSources) {
+            watchedProgram.pending.reset();
+            watchedProgram.pending.emplace(ShaderProgram::compileAsync(watchedProgram.changedSources->first,
+                                                                       watchedProgram.changedSources->second));
+            watchedProgram.changedSources.reset();
+        }
+
+        if (!watchedProgram.pending || !watchedProgram.pending->isReady()) {
+            continue;
+        }
+
+        if (watchedProgram.program->reloadFrom(*watchedProgram.pending)) {
+            cout << "Reloaded shader: " << watchedProgram.fragmentShaderFilePath << endl;
+        } else {
+            cout << "Shader reload failed, keeping previous program: " << watchedProgram.fragmentShaderFilePath
+                 << endl;
+        }
+        watchedProgram.pending.reset();
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "shaderApi.h"
+#include "shaderPreprocessor.h"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Watches shader source files with inotify and hot-reloads the programs built from them.
+// The background thread only reads the changed sources; compiling and swapping happen in update(),
+// which must be called on the GL thread between frames. A failed compile keeps the previous program.
+class ShaderWatcher {
+public:
+    ShaderWatcher();
+
+    ~ShaderWatcher();
+
+    ShaderWatcher(const ShaderWatcher &) = delete;
+
+    ShaderWatcher &operator=(const ShaderWatcher &) = delete;
+
+    // The program must outlive the watcher and stay at the same address. Sources go through
+    // ShaderPreprocessor with the given defines, and a change to any included file reloads the program too.
+    void watch(ShaderProgram &program, const std::string &vertexShaderFilePath,
+               const std::string &fragmentShaderFilePath, const ShaderDefines &defines = {});
+
+    void update();
+
+private:
+    struct ShaderSources {
+        std::string vertexShader;
+        std::string fragmentShader;
+        std::vector<std::string> includedFiles;
+    };
+
+    struct WatchedProgram {
+        ShaderProgram *program;
+        std::string vertexShaderFilePath;
+        std::string fragmentShaderFilePath;
+        ShaderDefines defines;
+        std::vector<std::string> includedFiles;
+        std::optional<std::pair<std::string, std::string>> changedSources;
+        std::optional<PendingShaderProgram> pending;
+    };
+
+    int inotifyDescriptor;
+    std::unordered_map<int, std::string> watchedDirectories;
+    std::vector<WatchedProgram> watchedPrograms;
+    std::mutex watchedProgramsMutex;
+    std::atomic<bool> running;
+    std::thread watcherThread;
+
+    void watchDirectory(const std::string &filePath);
+
+    void watchLoop();
+
+    void onFileChanged(const std::string &filePath);
+
+    // Touches only the files, so it runs without holding watchedProgramsMutex
+    static ShaderSources readSources(const std::string &vertexShaderFilePath,
+                                     const std::string &fragmentShaderFilePath, const ShaderDefines &defines);
+};
@@ -0,0 +1,557 @@
+#include <GL/glew.h>
+#include "blockCompressor.h"
+#include "floatLanes.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+const int BLOCK_TEXELS = 16;
+// BC7 interpolation weights of the 16 index values, out of 64
+const int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+const uint32_t BC7_MODE_6 = 1 << 6;
+
+// Encoder helpers, local to this file
+namespace {
+
+// Channel c of texel i is channels[c][i], so each channel loads straight into FloatLanes
+struct BlockValues {
+    float channels[4][BLOCK_TEXELS];
+};
+
+BlockValues toValues(const unsigned char *texels) {
+    BlockValues values{};
+    for (int i = 0; i < BLOCK_TEXELS; i++) {
+        for (int channel = 0; channel < 4; channel++) {
+            values.channels[channel][i] = texels[i * 4 + channel];
+        }
+    }
+    return values;
+}
+
+// Segment along the principal axis of the texels' first channelCount channels, spanning their projections.
+// The axis comes from a few power iterations on the covariance matrix.
+void fitLine(const BlockValues &values, int channelCount, float *start, float *end) {
+    float mean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int channel = 0; channel < channelCount; channel++) {
+        for (float value: values.channels[channel]) {
+            mean[channel] += value;
+        }
+        mean[channel] /= BLOCK_TEXELS;
+    }
+
+    float covariance[4][4] = {};
+    for (int i = 0; i < BLOCK_TEXELS; i++) {
+        for (int row = 0; row < channelCount; row++) {
+            for (int column = 0; column < channelCount; column++) {
+                covariance[row][column] += (values.channels[row][i] - mean[row]) *
+                                           (values.channels[column][i] - mean[column]);
+            }
+        }
+    }
+
+    int widest = 0;
+    for (int channel = 1; channel < channelCount; channel++) {
+        if (covariance[channel][channel] > covariance[widest][widest]) {
+            widest = channel;
+        }
+    }
+    float axis[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    copy(covariance[widest], covariance[widest] + channelCount, axis);
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float largest = 0.0f;
+        for (int row = 0; row < channelCount; row++) {
+            for (int column = 0; column < channelCount; column++) {
+                next[row] += covariance[row][column] * axis[column];
+            }
+            largest = max(largest, abs(next[row]));
+        }
+        if (largest == 0.0f) {
+            break;
+        }
+        for (int channel = 0; channel < channelCount; channel++) {
+            axis[channel] = next[channel] / largest;
+        }
+    }
+
+    float length = 0.0f;
+    for (int channel = 0; channel < channelCount; channel++) {
+        length += axis[channel] * axis[channel];
+    }
+    length = sqrt(length);
+
+    // A flat block has no axis; both ends sit on its color
+    float lowest = 0.0f;
+    float highest = 0.0f;
+    if (length > 0.0f) {
+        lowest = numeric_limits<float>::max();
+        highest = -numeric_limits<float>::max();
+        for (int channel = 0; channel < channelCount; channel++) {
+            axis[channel] /= length;
+        }
+        for (int i = 0; i < BLOCK_TEXELS; i++) {
+            float projection = 0.0f;
+            for (int channel = 0; channel < channelCount; channel++) {
+                projection += (values.channels[channel][i] - mean[channel]) * axis[channel];
+            }
+            lowest = min(lowest, projection);
+            highest = max(highest, projection);
+        }
+    }
+
+    for (int channel = 0; channel < 4; channel++) {
+        start[channel] = clamp(mean[channel] + lowest * axis[channel], 0.0f, 255.0f);
+        end[channel] = clamp(mean[channel] + highest * axis[channel], 0.0f, 255.0f);
+    }
+}
+
+// Where each texel falls on the segment from start to end, scaled to [0, steps] and clamped
+void project(const BlockValues &values, int firstChannel, int channelCount, const float *start, const float *end,
+             float steps, float *positions) {
+    float direction[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float lengthSquared = 0.0f;
+    for (int channel = firstChannel; channel < firstChannel + channelCount; channel++) {
+        direction[channel] = end[channel] - start[channel];
+        lengthSquared += direction[channel] * direction[channel];
+    }
+    if (lengthSquared == 0.0f) {
+        fill(positions, positions + BLOCK_TEXELS, 0.0f);
+        return;
+    }
+
+    FloatLanes scale = FloatLanes::broadcast(steps / lengthSquared);
+    FloatLanes zero = FloatLanes::broadcast(0.0f);
+    FloatLanes last = FloatLanes::broadcast(steps);
+    for (int first = 0; first < BLOCK_TEXELS; first += FloatLanes::SIZE) {
+        FloatLanes position = zero;
+        for (int channel = firstChannel; channel < firstChannel + channelCount; channel++) {
+            FloatLanes offset = FloatLanes::load(values.channels[channel] + first) -
+                                FloatLanes::broadcast(start[channel]);
+            position = position + offset * FloatLanes::broadcast(direction[channel]);
+        }
+        FloatLanes::min(FloatLanes::max(position * scale, zero), last).store(positions + first);
+    }
+}
+
+uint16_t toRgb565(const float *color) {
+    auto quantize = [](float value, int levels) {
+        return static_cast<uint16_t>(lround(value * static_cast<float>(levels) / 255.0f));
+    };
+    return static_cast<uint16_t>(quantize(color[0], 31) << 11 | quantize(color[1], 63) << 5 |
+                                 quantize(color[2], 31));
+}
+
+// Replicates the high bits into the low ones, as the decoders do
+void fromRgb565(uint16_t color, unsigned char *rgb) {
+    int red = color >> 11 & 31;
+    int green = color >> 5 & 63;
+    int blue = color & 31;
+    rgb[0] = static_cast<unsigned char>(red << 3 | red >> 2);
+    rgb[1] = static_cast<unsigned char>(green << 2 | green >> 4);
+    rgb[2] = static_cast<unsigned char>(blue << 3 | blue >> 2);
+}
+
+// Fields are packed from the lowest bit of the first byte upwards
+void writeBits(unsigned char *block, int &position, uint32_t value, int bits) {
+    for (int bit = 0; bit < bits; bit++, position++) {
+        if (value >> bit & 1) {
+            block[position / 8] |= static_cast<unsigned char>(1 << position % 8);
+        }
+    }
+}
+
+uint32_t readBits(const unsigned char *block, int &position, int bits) {
+    uint32_t value = 0;
+    for (int bit = 0; bit < bits; bit++, position++) {
+        value |= static_cast<uint32_t>(block[position / 8] >> position % 8 & 1) << bit;
+    }
+    return value;
+}
+
+// Seven bits per channel plus a p-bit shared by the endpoint's channels, choosing the p-bit that fits better
+void quantizeBc7Endpoint(const float *color, uint32_t *quantized, uint32_t &pBit) {
+    float bestError = numeric_limits<float>::max();
+    for (uint32_t candidate = 0; candidate < 2; candidate++) {
+        uint32_t channels[4];
+        float error = 0.0f;
+        for (int channel = 0; channel < 4; channel++) {
+            long value = lround((color[channel] - static_cast<float>(candidate)) / 2.0f);
+            channels[channel] = static_cast<uint32_t>(clamp(value, 0L, 127L));
+            float difference = static_cast<float>(channels[channel] << 1 | candidate) - color[channel];
+            error += difference * difference;
+        }
+        if (error < bestError) {
+            bestError = error;
+            copy(channels, channels + 4, quantized);
+            pBit = candidate;
+        }
+    }
+}
+
+// BC7 index whose weight is closest to a position out of 64
+int getNearestBc7Index(long position) {
+    static const array<int, 65> NEAREST = [] {
+        array<int, 65> nearest{};
+        for (int weight = 0; weight <= 64; weight++) {
+            int best = 0;
+            for (int index = 1; index < 16; index++) {
+                if (abs(BC7_WEIGHTS[index] - weight) < abs(BC7_WEIGHTS[best] - weight)) {
+                    best = index;
+                }
+            }
+            nearest[weight] = best;
+        }
+        return nearest;
+    }();
+    return NEAREST[clamp(position, 0L, 64L)];
+}
+
+}
+
+bool BlockCompressor::isSupported(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::Bc1:
+        case TextureFormat::Bc3:
+            return GLEW_EXT_texture_compression_s3tc;
+        case TextureFormat::Bc7:
+            return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+        case TextureFormat::Rgba8:
+        default:
+            return true;
+    }
+}
+
+TextureFormat BlockCompressor::chooseFormat(const MipChain &chain) {
+    bool opaque = true;
+    if (!chain.levels.empty()) {
+        const MipLevel &level = chain.levels.front();
+        size_t texels = static_cast<size_t>(level.width) * level.height;
+        for (size_t i = 0; i < texels && opaque; i++) {
+            opaque = chain.pixels[level.offset + i * 4 + 3] == 255;
+        }
+    }
+
+    if (opaque && isSupported(TextureFormat::Bc1)) {
+        return TextureFormat::Bc1;
+    }
+    if (isSupported(TextureFormat::Bc7)) {
+        return TextureFormat::Bc7;
+    }
+    if (isSupported(TextureFormat::Bc3)) {
+        return TextureFormat::Bc3;
+    }
+    return TextureFormat::Rgba8;
+}
+
+unsigned int BlockCompressor::getGlFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::Bc1:
+            return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case TextureFormat::Bc3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureFormat::Bc7:
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case TextureFormat::Rgba8:
+        default:
+            return GL_RGBA8;
+    }
+}
+
+int BlockCompressor::getBlockSize(TextureFormat format) {
+    return format == TextureFormat::Bc1 ? 8 : 16;
+}
+
+size_t BlockCompressor::getLevelSize(TextureFormat format, int width, int height) {
+    if (format == TextureFormat::Rgba8) {
+        return static_cast<size_t>(width) * height * 4;
+    }
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+}
+
+size_t BlockCompressor::getChainSize(TextureFormat format, int width, int height) {
+    size_t size = getLevelSize(format, width, height);
+    while (width > 1 || height > 1) {
+        width = max(width / 2, 1);
+        height = max(height / 2, 1);
+        size += getLevelSize(format, width, height);
+    }
+    return size;
+}
+
+void BlockCompressor::loadBlock(const unsigned char *pixels, int width, int height, int blockX, int blockY,
+                                unsigned char *texels) {
+    for (int y = 0; y < 4; y++) {
+        int row = min(blockY * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++) {
+            int column = min(blockX * 4 + x, width - 1);
+            memcpy(texels + (y * 4 + x) * 4, pixels + (static_cast<size_t>(row) * width + column) * 4, 4);
+        }
+    }
+}
+
+// Always in four-color mode (color0 > color1), which is also how BC3 reads its color half
+void BlockCompressor::encodeColorBlock(const unsigned char *texels, unsigned char *block) {
+    BlockValues values = toValues(texels);
+    float start[4];
+    float end[4];
+    fitLine(values, 3, start, end);
+
+    uint16_t color0 = toRgb565(end);
+    uint16_t color1 = toRgb565(start);
+    if (color0 < color1) {
+        swap(color0, color1);
+    }
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        unsigned char rgb0[3];
+        unsigned char rgb1[3];
+        fromRgb565(color0, rgb0);
+        fromRgb565(color1, rgb1);
+        float endpoint0[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float endpoint1[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        copy(rgb0, rgb0 + 3, endpoint0);
+        copy(rgb1, rgb1 + 3, endpoint1);
+
+        float positions[BLOCK_TEXELS];
+        project(values, 0, 3, endpoint0, endpoint1, 3.0f, positions);
+        // The palette is color0, color1, then the thirds from color0 towards color1
+        const uint32_t STEP_INDICES[4] = {0, 2, 3, 1};
+        for (int i = 0; i < BLOCK_TEXELS; i++) {
+            indices |= STEP_INDICES[lround(positions[i])] << (2 * i);
+        }
+    }
+
+    block[0] = static_cast<unsigned char>(color0);
+    block[1] = static_cast<unsigned char>(color0 >> 8);
+    block[2] = static_cast<unsigned char>(color1);
+    block[3] = static_cast<unsigned char>(color1 >> 8);
+    for (int i = 0; i < 4; i++) {
+        block[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+}
+
+// Eight-value mode (alpha0 > alpha1) between the block's extremes
+void BlockCompressor::encodeAlphaBlock(const unsigned char *texels, unsigned char *block) {
+    unsigned char alpha0 = 0;
+    unsigned char alpha1 = 255;
+    for (int i = 0; i < BLOCK_TEXELS; i++) {
+        alpha0 = max(alpha0, texels[i * 4 + 3]);
+        alpha1 = min(alpha1, texels[i * 4 + 3]);
+    }
+
+    uint64_t indices = 0;
+    if (alpha0 != alpha1) {
+        BlockValues values = toValues(texels);
+        float start[4] = {0.0f, 0.0f, 0.0f, static_cast<float>(alpha0)};
+        float end[4] = {0.0f, 0.0f, 0.0f, static_cast<float>(alpha1)};
+        float positions[BLOCK_TEXELS];
+        project(values, 3, 1, start, end, 7.0f, positions);
+        // The palette is alpha0, alpha1, then the sevenths from alpha0 towards alpha1
+        const uint64_t STEP_INDICES[8] = {0, 2, 3, 4, 5, 6, 7, 1};
+        for (int i = 0; i < BLOCK_TEXELS; i++) {
+            indices |= STEP_INDICES[lround(positions[i])] << (3 * i);
+        }
+    }
+
+    block[0] = alpha0;
+    block[1] = alpha1;
+    for (int i = 0; i < 6; i++) {
+        block[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+}
+
+void BlockCompressor::encodeBc7Block(const unsigned char *texels, unsigned char *block) {
+    BlockValues values = toValues(texels);
+    float start[4];
+    float end[4];
+    fitLine(values, 4, start, end);
+
+    uint32_t quantized[2][4];
+    uint32_t pBits[2];
+    quantizeBc7Endpoint(start, quantized[0], pBits[0]);
+    quantizeBc7Endpoint(end, quantized[1], pBits[1]);
+
+    float endpoints[2][4];
+    for (int endpoint = 0; endpoint < 2; endpoint++) {
+        for (int channel = 0; channel < 4; channel++) {
+            endpoints[endpoint][channel] = static_cast<float>(quantized[endpoint][channel] << 1 | pBits[endpoint]);
+        }
+    }
+    float positions[BLOCK_TEXELS];
+    project(values, 0, 4, endpoints[0], endpoints[1], 64.0f, positions);
+    int indices[BLOCK_TEXELS];
+    for (int i = 0; i < BLOCK_TEXELS; i++) {
+        indices[i] = getNearestBc7Index(lround(positions[i]));
+    }
+
+    // The first index is stored without its top bit, so it must be below 8. The weights are symmetric, so
+    // swapping the endpoints and mirroring the indices gives the same colors.
+    if (indices[0] >= 8) {
+        swap(quantized[0], quantized[1]);
+        swap(pBits[0], pBits[1]);
+        for (int &index: indices) {
+            index = 15 - index;
+        }
+    }
+
+    memset(block, 0, 16);
+    int position = 0;
+    writeBits(block, position, BC7_MODE_6, 7);
+    for (int channel = 0; channel < 4; channel++) {
+        writeBits(block, position, quantized[0][channel], 7);
+        writeBits(block, position, quantized[1][channel], 7);
+    }
+    writeBits(block, position, pBits[0], 1);
+    writeBits(block, position, pBits[1], 1);
+    for (int i = 0; i < BLOCK_TEXELS; i++) {
+        writeBits(block, position, static_cast<uint32_t>(indices[i]), i == 0 ? 3 : 4);
+    }
+}
+
+MipChain BlockCompressor::compress(const MipChain &chain, TextureFormat format, ThreadPool &pool) {
+    if (format == TextureFormat::Rgba8 || chain.format != TextureFormat::Rgba8) {
+        return chain;
+    }
+
+    MipChain compressed;
+    compressed.format = format;
+    size_t size = 0;
+    for (const MipLevel &level: chain.levels) {
+        compressed.levels.push_back({level.width, level.height, size});
+        size += getLevelSize(format, level.width, level.height);
+    }
+    compressed.pixels.resize(size);
+
+    int blockSize = getBlockSize(format);
+    for (size_t level = 0; level < chain.levels.size(); level++) {
+        const MipLevel &source = chain.levels[level];
+        const unsigned char *pixels = chain.pixels.data() + source.offset;
+        unsigned char *blocks = compressed.pixels.data() + compressed.levels[level].offset;
+        int blocksPerRow = (source.width + 3) / 4;
+
+        pool.parallelFor((source.height + 3) / 4, [&](int begin, int end) {
+            unsigned char texels[BLOCK_TEXELS * 4];
+            for (int blockY = begin; blockY < end; blockY++) {
+                for (int blockX = 0; blockX < blocksPerRow; blockX++) {
+                    loadBlock(pixels, source.width, source.height, blockX, blockY, texels);
+                    unsigned char *block = blocks + (static_cast<size_t>(blockY) * blocksPerRow + blockX) * blockSize;
+                    if (format == TextureFormat::Bc1) {
+                        encodeColorBlock(texels, block);
+                    } else if (format == TextureFormat::Bc3) {
+                        encodeAlphaBlock(texels, block);
+                        encodeColorBlock(texels, block + 8);
+                    } else {
+                        encodeBc7Block(texels, block);
+                    }
+                }
+            }
+        });
+    }
+
+    return compressed;
+}
+
+void BlockCompressor::decodeColorBlock(const unsigned char *block, bool fourColorsOnly, unsigned char *texels) {
+    auto color0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+    auto color1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+    unsigned char palette[4][4];
+    fromRgb565(color0, palette[0]);
+    fromRgb565(color1, palette[1]);
+    palette[0][3] = 255;
+    palette[1][3] = 255;
+
+    bool fourColors = fourColorsOnly || color0 > color1;
+    for (int channel = 0; channel < 3; channel++) {
+        int first = palette[0][channel];
+        int second = palette[1][channel];
+        if (fourColors) {
+            palette[2][channel] = static_cast<unsigned char>((2 * first + second) / 3);
+            palette[3][channel] = static_cast<unsigned char>((first + 2 * second) / 3);
+        } else {
+            palette[2][channel] = static_cast<unsigned char>((first + second) / 2);
+            palette[3][channel] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = fourColors ? 255 : 0;
+
+    uint32_t indices = block[4] | block[5] << 8 | block[6] << 16 | static_cast<uint32_t>(block[7]) << 24;
+    for (int i = 0; i < BLOCK_TEXELS; i++) {
+        memcpy(texels + i * 4, palette[indices >> (2 * i) & 3], 4);
+    }
+}
+
+void BlockCompressor::decodeAlphaBlock(const unsigned char *block, unsigned char *texels) {
+    int alpha0 = block[0];
+    int alpha1 = block[1];
+    int palette[8] = {alpha0, alpha1, 0, 0, 0, 0, 0, 255};
+    if (alpha0 > alpha1) {
+        for (int i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+        }
+    } else {
+        for (int i = 2; i < 6; i++) {
+            palette[i] = ((6 - i) * alpha0 + (i - 1) * alpha1) / 5;
+        }
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++) {
+        indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    }
+    for (int i = 0; i < BLOCK_TEXELS; i++) {
+        texels[i * 4 + 3] = static_cast<unsigned char>(palette[indices >> (3 * i) & 7]);
+    }
+}
+
+void BlockCompressor::decodeBc7Block(const unsigned char *block, unsigned char *texels) {
+    int position = 0;
+    if (readBits(block, position, 7) != BC7_MODE_6) {
+        memset(texels, 0, BLOCK_TEXELS * 4);
+        return;
+    }
+
+    uint32_t endpoints[2][4];
+    for (int channel = 0; channel < 4; channel++) {
+        endpoints[0][channel] = readBits(block, position, 7);
+        endpoints[1][channel] = readBits(block, position, 7);
+    }
+    for (auto &endpoint: endpoints) {
+        uint32_t pBit = readBits(block, position, 1);
+        for (uint32_t &channel: endpoint) {
+            channel = channel << 1 | pBit;
+        }
+    }
+
+    for (int i = 0; i < BLOCK_TEXELS; i++) {
+        int weight = BC7_WEIGHTS[readBits(block, position, i == 0 ? 3 : 4)];
+        for (int channel = 0; channel < 4; channel++) {
+            texels[i * 4 + channel] = static_cast<unsigned char>(
+                    ((64 - weight) * endpoints[0][channel] + weight * endpoints[1][channel] + 32) >> 6);
+        }
+    }
+}
+
+void BlockCompressor::decodeBlock(TextureFormat format, const unsigned char *block, unsigned char *texels) {
+    switch (format) {
+        case TextureFormat::Bc1:
+            decodeColorBlock(block, false, texels);
+            break;
+        case TextureFormat::Bc3:
+            decodeColorBlock(block + 8, true, texels);
+            decodeAlphaBlock(block, texels);
+            break;
+        case TextureFormat::Bc7:
+            decodeBc7Block(block, texels);
+            break;
+        case TextureFormat::Rgba8:
+            memcpy(texels, block, BLOCK_TEXELS * 4);
+            break;
+    }
+}
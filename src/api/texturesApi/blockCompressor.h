@@ -0,0 +1,53 @@
+#pragma once
+
+#include "textureDiskCache.h"
+#include "threadApi.h"
+#include <cstddef>
+
+// CPU encoder for the BC1, BC3 and BC7 block formats (S3TC and BPTC in GL). The endpoints of each 4x4 block are
+// fitted along the principal axis of its colors, and texels are projected onto that line eight at a time in
+// FloatLanes. Every BC7 block uses mode 6: one subset, RGBA endpoints with p-bits and 4-bit indices, which
+// suits the photos and icons the labs use.
+class BlockCompressor {
+public:
+    // Whether the context can sample the format; always true for Rgba8
+    static bool isSupported(TextureFormat format);
+
+    // BC1 for opaque images, otherwise BC7, or BC3 where BPTC is missing. Rgba8 when the context has neither.
+    static TextureFormat chooseFormat(const MipChain &chain);
+
+    // Encodes every level of an RGBA8 chain, spreading the block rows of each level over the pool
+    static MipChain compress(const MipChain &chain, TextureFormat format,
+                             ThreadPool &pool = ThreadPool::getShared());
+
+    // One block back to 64 bytes of RGBA8 texels, row by row. Only mode 6 BC7 blocks, as compress() writes
+    // them, are decoded; other modes come out transparent black.
+    static void decodeBlock(TextureFormat format, const unsigned char *block, unsigned char *texels);
+
+    static unsigned int getGlFormat(TextureFormat format);
+
+    // Block formats round each side up to whole blocks
+    static size_t getLevelSize(TextureFormat format, int width, int height);
+
+    // Every level from width x height down to 1x1
+    static size_t getChainSize(TextureFormat format, int width, int height);
+
+private:
+    static int getBlockSize(TextureFormat format);
+
+    // Edge blocks repeat the last row and column
+    static void loadBlock(const unsigned char *pixels, int width, int height, int blockX, int blockY,
+                          unsigned char *texels);
+
+    static void encodeColorBlock(const unsigned char *texels, unsigned char *block);
+
+    static void encodeAlphaBlock(const unsigned char *texels, unsigned char *block);
+
+    static void encodeBc7Block(const unsigned char *texels, unsigned char *block);
+
+    static void decodeColorBlock(const unsigned char *block, bool fourColorsOnly, unsigned char *texels);
+
+    static void decodeAlphaBlock(const unsigned char *block, unsigned char *texels);
+
+    static void decodeBc7Block(const unsigned char *block, unsigned char *texels);
+};
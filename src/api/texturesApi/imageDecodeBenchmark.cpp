@@ -0,0 +1,58 @@
+#include "texturesApi.h"
+#include "threadApi.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const string DEFAULT_IMAGE_DIRECTORY = "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/";
+const int IMAGES_PER_RUN = 64;
+const int RUNS = 3;
+
+// Decodes IMAGES_PER_RUN images, alternating between the files, on threadCount workers
+double measureImagesPerSecond(const vector<string> &files, unsigned int threadCount, bool flipVertically) {
+    ThreadPool pool(threadCount);
+    double best = 0.0;
+    for (int run = 0; run < RUNS; run++) {
+        vector<future<void>> decodes;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < IMAGES_PER_RUN; i++) {
+            const string &file = files[i % files.size()];
+            decodes.push_back(pool.submit([&file, flipVertically] {
+                ImageInfo image = decodeImage(file, 0, flipVertically);
+                if (!image.data) {
+                    cout << "Failed to load image! Path: " << file << endl;
+                }
+                freeImage(image);
+            }));
+        }
+        for (future<void> &decode: decodes) {
+            decode.get();
+        }
+        auto end = chrono::steady_clock::now();
+        double imagesPerSecond = IMAGES_PER_RUN / chrono::duration<double>(end - start).count();
+        best = max(best, imagesPerSecond);
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    string directory = argc > 1 ? string(argv[1]) + "/" : DEFAULT_IMAGE_DIRECTORY;
+    vector<string> files = {directory + "container.jpg", directory + "awesomeface.png"};
+
+    unsigned int maxThreads = max(thread::hardware_concurrency(), 1u);
+    cout << "Decoding container.jpg and awesomeface.png, " << IMAGES_PER_RUN << " images per run" << endl;
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        double flipped = measureImagesPerSecond(files, threads, true);
+        double unflipped = measureImagesPerSecond(files, threads, false);
+        cout << threads << " threads: " << flipped << " images/s flipped in decode, " << unflipped
+             << " images/s flipped on upload" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include <GL/glew.h>
+#include "textureCache.h"
+#include "texturesApi.h"
+#include "textureDiskCache.h"
+#include "blockCompressor.h"
+#include "glStateApi.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using namespace std;
+
+CachedTexture::CachedTexture(unsigned int inputTexture, int inputWidth, int inputHeight, size_t inputBytes,
+                             size_t inputUncompressedBytes)
+        : texture(inputTexture), width(inputWidth), height(inputHeight), bytes(inputBytes),
+          uncompressedBytes(inputUncompressedBytes) {
+    TextureCache::State &state = TextureCache::getState();
+    state.residentTextures++;
+    state.residentBytes += bytes;
+    state.uncompressedBytes += uncompressedBytes;
+}
+
+CachedTexture::~CachedTexture() {
+    glDeleteTextures(1, &texture);
+    GlState::onTextureDeleted(texture);
+
+    TextureCache::State &state = TextureCache::getState();
+    state.residentTextures--;
+    state.residentBytes -= bytes;
+    state.uncompressedBytes -= uncompressedBytes;
+}
+
+unsigned int CachedTexture::getTexture() const {
+    return texture;
+}
+
+int CachedTexture::getWidth() const {
+    return width;
+}
+
+int CachedTexture::getHeight() const {
+    return height;
+}
+
+size_t CachedTexture::getBytes() const {
+    return bytes;
+}
+
+size_t CachedTexture::getUncompressedBytes() const {
+    return uncompressedBytes;
+}
+
+TextureCache::State::State() {
+    if (const char *fromEnvironment = getenv("TEXTURE_CACHE_COMPRESS")) {
+        compressed = *fromEnvironment != '\0' && string(fromEnvironment) != "0";
+    }
+
+    if (const char *fromEnvironment = getenv("TEXTURE_CACHE_DIR")) {
+        diskCacheDirectory = fromEnvironment;
+        return;
+    }
+    error_code error;
+    filesystem::path temporaryDirectory = filesystem::temp_directory_path(error);
+    if (!error) {
+        diskCacheDirectory = (temporaryDirectory / "graphicsLabsTextureCache").string();
+    }
+}
+
+TextureCache::State &TextureCache::getState() {
+    static State state;
+    return state;
+}
+
+uint64_t TextureCache::hashContent(const unsigned char *data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+TextureHandle TextureCache::find(map<string, weak_ptr<const CachedTexture>> &textures, const string &key) {
+    auto found = textures.find(key);
+    if (found == textures.end()) {
+        return nullptr;
+    }
+    TextureHandle handle = found->second.lock();
+    if (!handle) {
+        textures.erase(found);
+    }
+    return handle;
+}
+
+// Not cached, so the file is tried again on the next load
+TextureHandle TextureCache::createEmpty(const string &filePath) {
+    cout << "Failed to load texture! Path: " << filePath << endl;
+    getState().misses++;
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    return make_shared<const CachedTexture>(texture, 0, 0, 0, 0);
+}
+
+TextureHandle TextureCache::load(const string &filePath, int channels) {
+    State &state = getState();
+    string pathKey = to_string(channels) + ":" + filePath;
+    TextureHandle handle = find(state.byPath, pathKey);
+    if (handle) {
+        state.hits++;
+        return handle;
+    }
+
+    ifstream file(filePath, ios::binary);
+    if (!file) {
+        return createEmpty(filePath);
+    }
+    vector<unsigned char> content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    uint64_t contentHash = hashContent(content.data(), content.size());
+    string contentKey = to_string(channels) + ":" + to_string(contentHash);
+    handle = find(state.byContent, contentKey);
+    if (handle) {
+        state.hits++;
+        state.byPath[pathKey] = handle;
+        return handle;
+    }
+
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    GlState::activeTexture(0);
+    GlState::bindTexture(0, GL_TEXTURE_2D, texture);
+    int width = 0;
+    int height = 0;
+    size_t bytes = 0;
+    bool direct = state.diskCacheDirectory.empty() && !state.compressed;
+    bool uploaded = direct ? upload(content, channels, width, height, bytes)
+                           : uploadMipChain(content, contentHash, width, height, bytes);
+    if (!uploaded) {
+        glDeleteTextures(1, &texture);
+        GlState::onTextureDeleted(texture);
+        return createEmpty(filePath);
+    }
+
+    state.misses++;
+    size_t uncompressedBytes = direct ? bytes : BlockCompressor::getChainSize(TextureFormat::Rgba8, width, height);
+    handle = make_shared<const CachedTexture>(texture, width, height, bytes, uncompressedBytes);
+    state.byPath[pathKey] = handle;
+    state.byContent[contentKey] = handle;
+    return handle;
+}
+
+bool TextureCache::upload(const vector<unsigned char> &content, int channels, int &width, int &height,
+                          size_t &bytes) {
+    ImageInfo image = decodeImage(content.data(), content.size(), channels);
+    if (!image.data) {
+        return false;
+    }
+    uploadImage(image, true);
+
+    // The mip chain adds a third on top of level 0
+    size_t levelBytes = static_cast<size_t>(image.width) * image.height * image.nrChannels;
+    width = image.width;
+    height = image.height;
+    bytes = levelBytes + levelBytes / 3;
+    freeImage(image);
+    return true;
+}
+
+// Decoded flipped, so the stored rows are already in upload order
+bool TextureCache::uploadMipChain(const vector<unsigned char> &content, uint64_t contentHash, int &width,
+                                  int &height, size_t &bytes) {
+    const State &state = getState();
+    const string &directory = state.diskCacheDirectory;
+    if (!directory.empty() &&
+        TextureDiskCache::uploadCached(directory, contentHash, state.compressed, width, height, bytes)) {
+        return true;
+    }
+
+    ImageInfo image = decodeImage(content.data(), content.size(), 4, true);
+    if (!image.data) {
+        return false;
+    }
+    MipChain chain = TextureDiskCache::buildMipChain(image);
+    freeImage(image);
+    if (state.compressed) {
+        TextureFormat format = BlockCompressor::chooseFormat(chain);
+        if (format != TextureFormat::Rgba8) {
+            chain = BlockCompressor::compress(chain, format);
+        }
+    }
+
+    if (!directory.empty()) {
+        TextureDiskCache::save(directory, contentHash, state.compressed, chain);
+    }
+    TextureDiskCache::upload(chain.format, chain.pixels.data(), chain.levels);
+    width = chain.levels.front().width;
+    height = chain.levels.front().height;
+    bytes = chain.pixels.size();
+    return true;
+}
+
+TextureCacheStats TextureCache::getStats() {
+    State &state = getState();
+    return {state.hits, state.misses, state.residentTextures, state.residentBytes, state.uncompressedBytes};
+}
+
+void TextureCache::setDiskCacheDirectory(const string &directory) {
+    getState().diskCacheDirectory = directory;
+}
+
+string TextureCache::getDiskCacheDirectory() {
+    return getState().diskCacheDirectory;
+}
+
+void TextureCache::setCompressed(bool compressed) {
+    getState().compressed = compressed;
+}
+
+bool TextureCache::isCompressed() {
+    return getState().compressed;
+}
+
+void TextureCache::resetCounters() {
+    State &state = getState();
+    state.hits = 0;
+    state.misses = 0;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct TextureCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    // Live textures and their GPU memory, mipmaps included
+    size_t residentTextures;
+    size_t residentBytes;
+    // What residentBytes would be without block compression
+    size_t uncompressedBytes;
+};
+
+// A GL texture owned by every handle to it; the last handle to go deletes it
+class CachedTexture {
+public:
+    CachedTexture(unsigned int inputTexture, int inputWidth, int inputHeight, size_t inputBytes,
+                  size_t inputUncompressedBytes);
+
+    ~CachedTexture();
+
+    CachedTexture(const CachedTexture &) = delete;
+
+    CachedTexture &operator=(const CachedTexture &) = delete;
+
+    unsigned int getTexture() const;
+
+    int getWidth() const;
+
+    int getHeight() const;
+
+    size_t getBytes() const;
+
+    size_t getUncompressedBytes() const;
+
+private:
+    unsigned int texture;
+    int width;
+    int height;
+    size_t bytes;
+    size_t uncompressedBytes;
+};
+
+typedef std::shared_ptr<const CachedTexture> TextureHandle;
+
+// Shares one texture between everything that loads the same image. A path that is already loaded is a hit
+// without touching the file. A new path is read and hashed, and its content is a hit as well when another path
+// with the same bytes is loaded; only new content is decoded and uploaded. The cache holds no references
+// itself, so a texture lives exactly as long as its handles.
+// New content goes through the TextureDiskCache when a disk cache directory is set: the first run decodes it to
+// RGBA8 with a CPU mip chain, block compresses the chain when compression is turned on and stores that, later
+// runs upload the stored levels.
+class TextureCache {
+public:
+    // channels 3 or 4, as in bindTextureRGB and bindTextureRGBA. A file that cannot be read or decoded gives
+    // an empty texture, as it does there.
+    static TextureHandle load(const std::string &filePath, int channels);
+
+    // Defaults to $TEXTURE_CACHE_DIR or <tmp>/graphicsLabsTextureCache; an empty path disables the disk cache.
+    // Without it and without compression, the decoded image is uploaded with its requested channels and
+    // glGenerateMipmap.
+    static void setDiskCacheDirectory(const std::string &directory);
+
+    static std::string getDiskCacheDirectory();
+
+    // Off by default; setting $TEXTURE_CACHE_COMPRESS to anything but 0 turns it on. Chains are encoded in the
+    // format BlockCompressor::chooseFormat picks, and stay RGBA8 when the context supports none; with the disk
+    // cache off they are encoded again on every new load.
+    static void setCompressed(bool compressed);
+
+    static bool isCompressed();
+
+    static TextureCacheStats getStats();
+
+    static void resetCounters();
+
+    // 64-bit FNV-1a
+    static uint64_t hashContent(const unsigned char *data, size_t size);
+
+private:
+    struct State {
+        // "channels:path" and "channels:content hash"
+        std::map<std::string, std::weak_ptr<const CachedTexture>> byPath;
+        std::map<std::string, std::weak_ptr<const CachedTexture>> byContent;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t residentTextures = 0;
+        size_t residentBytes = 0;
+        size_t uncompressedBytes = 0;
+        std::string diskCacheDirectory;
+        bool compressed = false;
+
+        State();
+    };
+
+    static State &getState();
+
+    // Into the texture bound to GL_TEXTURE_2D; false when the content does not decode
+    static bool upload(const std::vector<unsigned char> &content, int channels, int &width, int &height,
+                       size_t &bytes);
+
+    static bool uploadMipChain(const std::vector<unsigned char> &content, uint64_t contentHash, int &width,
+                               int &height, size_t &bytes);
+
+    static TextureHandle createEmpty(const std::string &filePath);
+
+    static TextureHandle find(std::map<std::string, std::weak_ptr<const CachedTexture>> &textures,
+                              const std::string &key);
+
+    friend class CachedTexture;
+};
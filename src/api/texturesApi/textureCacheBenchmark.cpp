@@ -0,0 +1,86 @@
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "contextApi.h"
+#include "textureCache.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const string DEFAULT_IMAGE_DIRECTORY = "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/";
+const int STARTUP_ROUNDS = 8;
+
+// Average time to load every file once, as a fresh run would. The handles are dropped at the end of each
+// round, so every load misses the in-memory cache. With emptyDiskCache the cache files are removed before each
+// round, outside the measured time.
+double measureStartupMillis(const vector<string> &files, bool emptyDiskCache) {
+    double total = 0.0;
+    for (int round = 0; round < STARTUP_ROUNDS; round++) {
+        if (emptyDiskCache) {
+            error_code error;
+            filesystem::remove_all(TextureCache::getDiskCacheDirectory(), error);
+        }
+
+        auto start = chrono::steady_clock::now();
+        vector<TextureHandle> textures;
+        for (const string &file: files) {
+            textures.push_back(TextureCache::load(file, 4));
+        }
+        glFinish();
+        auto end = chrono::steady_clock::now();
+        total += static_cast<double>(chrono::duration_cast<chrono::microseconds>(end - start).count()) / 1000.0;
+    }
+    return total / STARTUP_ROUNDS;
+}
+
+// Run with --headless or LIBGL_ALWAYS_SOFTWARE=1 to measure under Mesa llvmpipe; an optional directory
+// argument replaces the one with container.jpg and awesomeface.png
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, 64, 64, "Texture Cache Benchmark");
+    if (!context.isCreated()) {
+        return -1;
+    }
+
+    string directory = DEFAULT_IMAGE_DIRECTORY;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]).rfind("--", 0) != 0) {
+            directory = string(argv[i]) + "/";
+        }
+    }
+    vector<string> files = {directory + "container.jpg", directory + "awesomeface.png"};
+
+    filesystem::path cacheDirectory = filesystem::temp_directory_path() / "textureCacheBenchmarkCache";
+    filesystem::remove_all(cacheDirectory);
+
+    TextureCache::setCompressed(false);
+    TextureCache::setDiskCacheDirectory("");
+    double uncachedStartup = measureStartupMillis(files, false);
+    TextureCache::setDiskCacheDirectory(cacheDirectory.string());
+    double coldStartup = measureStartupMillis(files, true);
+    double warmStartup = measureStartupMillis(files, false);
+
+    TextureCache::setCompressed(true);
+    double compressedColdStartup = measureStartupMillis(files, true);
+    double compressedWarmStartup = measureStartupMillis(files, false);
+    vector<TextureHandle> compressed;
+    for (const string &file: files) {
+        compressed.push_back(TextureCache::load(file, 4));
+    }
+    TextureCacheStats stats = TextureCache::getStats();
+    filesystem::remove_all(cacheDirectory);
+
+    cout << "Renderer: " << glGetString(GL_RENDERER) << endl;
+    cout << "container.jpg and awesomeface.png, average of " << STARTUP_ROUNDS << " startups" << endl;
+    cout << "decode and glGenerateMipmap:               " << uncachedStartup << " ms" << endl;
+    cout << "cold disk cache (decode, CPU mips, write): " << coldStartup << " ms" << endl;
+    cout << "warm disk cache (mmap and upload levels):  " << warmStartup << " ms" << endl;
+    cout << "cold disk cache, block compressed:         " << compressedColdStartup << " ms" << endl;
+    cout << "warm disk cache, block compressed:         " << compressedWarmStartup << " ms" << endl;
+    cout << "block compressed chains: " << stats.residentBytes / 1024 << " KB, " << stats.uncompressedBytes / 1024
+         << " KB as RGBA8" << endl;
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "blockCompressor.h"
+#include "textureDiskCache.h"
+#include "threadApi.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const string DEFAULT_IMAGE_DIRECTORY = "/home/mlgmag/CLionProjects/graphicsLabs/src/resources/img/";
+const int RUNS = 3;
+
+struct NamedFormat {
+    TextureFormat format;
+    string name;
+};
+
+// Fastest of RUNS encodes of the whole chain
+double measureEncodeMillis(const MipChain &chain, TextureFormat format, ThreadPool &pool) {
+    double best = 0.0;
+    for (int run = 0; run < RUNS; run++) {
+        auto start = chrono::steady_clock::now();
+        MipChain compressed = BlockCompressor::compress(chain, format, pool);
+        auto end = chrono::steady_clock::now();
+        double millis = static_cast<double>(chrono::duration_cast<chrono::microseconds>(end - start).count()) / 1000.0;
+        best = run == 0 ? millis : min(best, millis);
+    }
+    return best;
+}
+
+// Over level 0, leaving out alpha for BC1, which is only chosen for opaque images
+double measurePsnr(const MipChain &chain, const MipChain &compressed) {
+    const MipLevel &level = chain.levels.front();
+    int channels = compressed.format == TextureFormat::Bc1 ? 3 : 4;
+    const unsigned char *pixels = chain.pixels.data();
+    int blocksPerRow = (level.width + 3) / 4;
+    size_t blockSize = BlockCompressor::getLevelSize(compressed.format, 4, 4);
+
+    double squaredError = 0.0;
+    unsigned char texels[64];
+    for (int y = 0; y < level.height; y += 4) {
+        for (int x = 0; x < level.width; x += 4) {
+            size_t block = static_cast<size_t>(y / 4) * blocksPerRow + x / 4;
+            BlockCompressor::decodeBlock(compressed.format, compressed.pixels.data() + block * blockSize, texels);
+            for (int row = y; row < min(y + 4, level.height); row++) {
+                for (int column = x; column < min(x + 4, level.width); column++) {
+                    for (int channel = 0; channel < channels; channel++) {
+                        double difference = pixels[(static_cast<size_t>(row) * level.width + column) * 4 + channel] -
+                                            texels[((row - y) * 4 + column - x) * 4 + channel];
+                        squaredError += difference * difference;
+                    }
+                }
+            }
+        }
+    }
+    double meanSquaredError = squaredError / (static_cast<double>(level.width) * level.height * channels);
+    return meanSquaredError == 0.0 ? INFINITY : 10.0 * log10(255.0 * 255.0 / meanSquaredError);
+}
+
+// Encodes on the CPU only, so it needs no GL context; an optional directory argument replaces the one with
+// container.jpg and awesomeface.png
+int main(int argc, char *argv[]) {
+    string directory = argc > 1 ? string(argv[1]) + "/" : DEFAULT_IMAGE_DIRECTORY;
+    vector<string> files = {directory + "container.jpg", directory + "awesomeface.png"};
+    vector<NamedFormat> formats = {{TextureFormat::Bc1, "BC1"},
+                                   {TextureFormat::Bc3, "BC3"},
+                                   {TextureFormat::Bc7, "BC7"}};
+
+    unsigned int maxThreads = max(thread::hardware_concurrency(), 1u);
+    ThreadPool singleThread(1);
+    ThreadPool allThreads(maxThreads);
+
+    for (const string &file: files) {
+        ImageInfo image = decodeImage(file, 4, true);
+        if (!image.data) {
+            cout << "Failed to load image! Path: " << file << endl;
+            continue;
+        }
+        MipChain chain = TextureDiskCache::buildMipChain(image);
+        cout << file << ": " << image.width << "x" << image.height << ", mip chain " << chain.pixels.size() / 1024
+             << " KB as RGBA8" << endl;
+        freeImage(image);
+
+        for (const NamedFormat &format: formats) {
+            MipChain compressed = BlockCompressor::compress(chain, format.format, allThreads);
+            double singleMillis = measureEncodeMillis(chain, format.format, singleThread);
+            double allMillis = measureEncodeMillis(chain, format.format, allThreads);
+            double ratio = static_cast<double>(compressed.pixels.size()) / static_cast<double>(chain.pixels.size());
+            cout << format.name << ": " << compressed.pixels.size() / 1024 << " KB (" << ratio * 100.0
+                 << "% of RGBA8), " << measurePsnr(chain, compressed) << " dB PSNR, encoded in " << singleMillis
+                 << " ms on 1 thread, " << allMillis << " ms on " << maxThreads << " threads" << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <GL/glew.h>
+#include "textureDiskCache.h"
+#include "blockCompressor.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+const uint32_t TextureDiskCache::MAGIC;
+const uint32_t TextureDiskCache::VERSION;
+
+MipChain TextureDiskCache::buildMipChain(const ImageInfo &image) {
+    int width = image.width;
+    int height = image.height;
+    size_t levelSize = static_cast<size_t>(width) * height * 4;
+
+    MipChain chain;
+    chain.pixels.reserve(levelSize + levelSize / 3 + 4 * 32);
+    chain.pixels.assign(image.data, image.data + levelSize);
+    chain.levels.push_back({width, height, 0});
+
+    while (width > 1 || height > 1) {
+        int nextWidth = max(width / 2, 1);
+        int nextHeight = max(height / 2, 1);
+        size_t offset = chain.pixels.size();
+        chain.pixels.resize(offset + static_cast<size_t>(nextWidth) * nextHeight * 4);
+        const unsigned char *source = chain.pixels.data() + chain.levels.back().offset;
+        unsigned char *destination = chain.pixels.data() + offset;
+
+        // A side that is already 1 texel reads its only row or column twice
+        for (int y = 0; y < nextHeight; y++) {
+            const unsigned char *row0 = source + static_cast<size_t>(2 * y) * width * 4;
+            const unsigned char *row1 = source + static_cast<size_t>(min(2 * y + 1, height - 1)) * width * 4;
+            for (int x = 0; x < nextWidth; x++) {
+                int x0 = 2 * x * 4;
+                int x1 = min(2 * x + 1, width - 1) * 4;
+                for (int channel = 0; channel < 4; channel++) {
+                    int sum = row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel];
+                    destination[(y * nextWidth + x) * 4 + channel] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+
+        chain.levels.push_back({nextWidth, nextHeight, offset});
+        width = nextWidth;
+        height = nextHeight;
+    }
+
+    return chain;
+}
+
+// RGBA8 rows are always 4-byte aligned, so the default unpack alignment applies
+void TextureDiskCache::upload(TextureFormat format, const unsigned char *pixels, const vector<MipLevel> &levels) {
+    for (size_t level = 0; level < levels.size(); level++) {
+        const MipLevel &mip = levels[level];
+        if (format == TextureFormat::Rgba8) {
+            glTexImage2D(GL_TEXTURE_2D, static_cast<int>(level), GL_RGBA8, mip.width, mip.height, 0, GL_RGBA,
+                         GL_UNSIGNED_BYTE, pixels + mip.offset);
+        } else {
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<int>(level), BlockCompressor::getGlFormat(format),
+                                   mip.width, mip.height, 0,
+                                   static_cast<int>(BlockCompressor::getLevelSize(format, mip.width, mip.height)),
+                                   pixels + mip.offset);
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(levels.size()) - 1);
+}
+
+string TextureDiskCache::getPath(const string &directory, uint64_t contentHash, bool compressed) {
+    std::stringstream fileName;
+    fileName << hex << contentHash << (compressed ? ".bc.mips" : ".mips");
+    return (filesystem::path(directory) / fileName.str()).string();
+}
+
+bool TextureDiskCache::uploadCached(const string &directory, uint64_t contentHash, bool compressed, int &width,
+                                    int &height, size_t &bytes) {
+    int descriptor = open(getPath(directory, contentHash, compressed).c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat fileStat{};
+    if (fstat(descriptor, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sizeof(FileHeader)) {
+        close(descriptor);
+        return false;
+    }
+    auto fileSize = static_cast<size_t>(fileStat.st_size);
+    void *mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // The mapping outlives the descriptor
+    close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    const auto *file = static_cast<const unsigned char *>(mapping);
+
+    FileHeader header{};
+    memcpy(&header, file, sizeof(header));
+    size_t pixelsStart = sizeof(FileHeader) + static_cast<size_t>(header.levelCount) * sizeof(FileLevel);
+    bool valid = header.magic == MAGIC && header.version == VERSION && header.contentHash == contentHash &&
+                 header.levelCount > 0 && header.levelCount <= 32 && pixelsStart <= fileSize &&
+                 header.format <= static_cast<uint32_t>(TextureFormat::Bc7);
+    auto format = static_cast<TextureFormat>(header.format);
+    // A chain is re-encoded when its block format went missing, and an RGBA8 one saved under compression by a
+    // context without block formats is re-encoded once one is available
+    if (valid && format != TextureFormat::Rgba8) {
+        valid = compressed && BlockCompressor::isSupported(format);
+    } else if (valid && compressed) {
+        valid = !BlockCompressor::isSupported(TextureFormat::Bc1) &&
+                !BlockCompressor::isSupported(TextureFormat::Bc3) &&
+                !BlockCompressor::isSupported(TextureFormat::Bc7);
+    }
+
+    // A truncated or foreign file is treated as missing and overwritten by the next save
+    vector<MipLevel> levels;
+    for (uint32_t i = 0; valid && i < header.levelCount; i++) {
+        FileLevel level{};
+        memcpy(&level, file + sizeof(FileHeader) + i * sizeof(FileLevel), sizeof(level));
+        size_t levelSize = BlockCompressor::getLevelSize(format, static_cast<int>(level.width),
+                                                         static_cast<int>(level.height));
+        size_t levelEnd = pixelsStart + level.offset + levelSize;
+        valid = level.width > 0 && level.height > 0 && levelEnd <= fileSize;
+        levels.push_back({static_cast<int>(level.width), static_cast<int>(level.height),
+                          static_cast<size_t>(level.offset)});
+    }
+
+    if (valid) {
+        upload(format, file + pixelsStart, levels);
+        width = levels.front().width;
+        height = levels.front().height;
+        bytes = fileSize - pixelsStart;
+    }
+    munmap(mapping, fileSize);
+    return valid;
+}
+
+void TextureDiskCache::save(const string &directory, uint64_t contentHash, bool compressed, const MipChain &chain) {
+    filesystem::path path = getPath(directory, contentHash, compressed);
+    error_code error;
+    filesystem::create_directories(path.parent_path(), error);
+
+    FileHeader header{MAGIC, VERSION, contentHash, static_cast<uint32_t>(chain.levels.size()),
+                      static_cast<uint32_t>(chain.format)};
+    vector<FileLevel> levels;
+    for (const MipLevel &level: chain.levels) {
+        levels.push_back({static_cast<uint32_t>(level.width), static_cast<uint32_t>(level.height), level.offset});
+    }
+
+    // Written next to the target and renamed, so a concurrent reader never maps a partial file
+    filesystem::path temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        ofstream cacheFile(temporaryPath, ios::binary | ios::trunc);
+        if (!cacheFile.is_open()) {
+            return;
+        }
+        cacheFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        cacheFile.write(reinterpret_cast<const char *>(levels.data()),
+                        static_cast<streamsize>(levels.size() * sizeof(FileLevel)));
+        cacheFile.write(reinterpret_cast<const char *>(chain.pixels.data()),
+                        static_cast<streamsize>(chain.pixels.size()));
+    }
+    filesystem::rename(temporaryPath, path, error);
+}
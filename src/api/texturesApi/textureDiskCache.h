@@ -0,0 +1,72 @@
+#pragma once
+
+#include "texturesApi.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct MipLevel {
+    int width;
+    int height;
+    // Bytes from the start of the pixels
+    size_t offset;
+};
+
+enum class TextureFormat {
+    Rgba8,
+    Bc1,
+    Bc3,
+    Bc7
+};
+
+// Pixels of every mip level down to 1x1, level 0 first, rows in the order glTexImage2D expects. Block formats
+// hold 4x4 blocks in the same order.
+struct MipChain {
+    TextureFormat format = TextureFormat::Rgba8;
+    std::vector<MipLevel> levels;
+    std::vector<unsigned char> pixels;
+};
+
+// Decoded textures stored on disk with their mip chains, so that later runs skip both the decode and
+// glGenerateMipmap. A cache file is named after the hash of the encoded image it came from, with separate files
+// for plain and block compressed chains, and holds a header, the level table and the pixels. It is read with
+// mmap and every level goes straight from the mapping to glTexImage2D.
+class TextureDiskCache {
+public:
+    // Halves each side with a 2x2 box filter, rounding sizes down like GL; image must have 4 channels
+    static MipChain buildMipChain(const ImageInfo &image);
+
+    // Into the texture bound to GL_TEXTURE_2D, without glGenerateMipmap; block formats go through
+    // glCompressedTexImage2D
+    static void upload(TextureFormat format, const unsigned char *pixels, const std::vector<MipLevel> &levels);
+
+    // Uploads the cached chain of the content into the texture bound to GL_TEXTURE_2D. False when there is no
+    // valid cache file for it or its format is not what a new encode would give: RGBA8 when compressed is false,
+    // otherwise a block format the context can sample, or RGBA8 only when it can sample none. width, height and
+    // bytes describe level 0 and the whole chain.
+    static bool uploadCached(const std::string &directory, uint64_t contentHash, bool compressed, int &width,
+                             int &height, size_t &bytes);
+
+    static void save(const std::string &directory, uint64_t contentHash, bool compressed, const MipChain &chain);
+
+    static std::string getPath(const std::string &directory, uint64_t contentHash, bool compressed);
+
+private:
+    static const uint32_t MAGIC = 0x58544C47;
+    static const uint32_t VERSION = 2;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t contentHash;
+        uint32_t levelCount;
+        uint32_t format;
+    };
+
+    struct FileLevel {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset;
+    };
+};
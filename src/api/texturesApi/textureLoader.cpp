@@ -0,0 +1,116 @@
+#include <GL/glew.h>
+#include "textureLoader.h"
+#include "glStateApi.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+const size_t TextureLoader::DEFAULT_UPLOAD_BUDGET;
+
+TextureLoader::TextureLoader(size_t uploadBudget, ThreadPool &pool) : pool(pool), uploadBudget(uploadBudget) {
+}
+
+TextureLoader::~TextureLoader() {
+    for (future<void> &decode: decodes) {
+        decode.wait();
+    }
+    collectDecoded();
+    for (DecodedImage &decodedImage: waiting) {
+        freeImage(decodedImage.image);
+    }
+}
+
+unsigned int TextureLoader::load(const string &filePath, int channels) {
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    uploadPlaceholder(texture);
+    pending.insert(texture);
+
+    // Decoded top-down; uploadImage flips the rows on their way into the texture
+    decodes.push_back(pool.submit([this, texture, filePath, channels] {
+        decoded.push({texture, filePath, decodeImage(filePath, channels)});
+    }));
+
+    return texture;
+}
+
+void TextureLoader::collectDecoded() {
+    for (DecodedImage &decodedImage: decoded.popAll()) {
+        waiting.push_back(std::move(decodedImage));
+    }
+
+    decodes.erase(remove_if(decodes.begin(), decodes.end(), [](future<void> &decode) {
+        return decode.wait_for(chrono::seconds(0)) == future_status::ready;
+    }), decodes.end());
+}
+
+int TextureLoader::update() {
+    collectDecoded();
+
+    int uploaded = 0;
+    size_t spent = 0;
+    while (!waiting.empty()) {
+        size_t size = getSize(waiting.front().image);
+        if (uploaded > 0 && spent + size > uploadBudget) {
+            break;
+        }
+        upload(waiting.front());
+        waiting.pop_front();
+        spent += size;
+        uploaded++;
+    }
+    return uploaded;
+}
+
+void TextureLoader::finish() {
+    for (future<void> &decode: decodes) {
+        decode.wait();
+    }
+    collectDecoded();
+    while (!waiting.empty()) {
+        upload(waiting.front());
+        waiting.pop_front();
+    }
+}
+
+bool TextureLoader::isReady(unsigned int texture) const {
+    return pending.count(texture) == 0;
+}
+
+int TextureLoader::getPendingCount() const {
+    return static_cast<int>(pending.size());
+}
+
+void TextureLoader::setUploadBudget(size_t bytes) {
+    uploadBudget = bytes;
+}
+
+// A failed image keeps its placeholder and stops being pending, like bindTextureRGB leaves an empty texture
+void TextureLoader::upload(DecodedImage &decodedImage) {
+    pending.erase(decodedImage.texture);
+    const ImageInfo &image = decodedImage.image;
+    if (!image.data) {
+        cout << "Failed to load texture! Path: " << decodedImage.filePath << endl;
+        return;
+    }
+
+    // The render loop leaves other units active between updates, and the upload goes to the active one
+    GlState::activeTexture(0);
+    GlState::bindTexture(0, GL_TEXTURE_2D, decodedImage.texture);
+    uploadImage(image, true);
+    freeImage(decodedImage.image);
+}
+
+// A single texel is a complete texture under the default mipmapped filter, so it samples as grey, not black
+void TextureLoader::uploadPlaceholder(unsigned int texture) {
+    const unsigned char grey[4] = {128, 128, 128, 255};
+    GlState::activeTexture(0);
+    GlState::bindTexture(0, GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+}
+
+size_t TextureLoader::getSize(const ImageInfo &image) {
+    return static_cast<size_t>(image.width) * image.height * image.nrChannels;
+}
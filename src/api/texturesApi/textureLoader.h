@@ -0,0 +1,72 @@
+#pragma once
+
+#include "texturesApi.h"
+#include "mpscQueue.h"
+#include "threadApi.h"
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Loads textures without blocking the render thread on decoding. load() returns a texture name right away,
+// holding a one-texel grey placeholder; the file is decoded on a worker pool and the image comes back through
+// a lock-free queue. update(), called once per frame on the GL thread, uploads the decoded images until the
+// frame's byte budget is spent, so a scene's textures show up over a few frames instead of stalling startup.
+class TextureLoader {
+public:
+    static const size_t DEFAULT_UPLOAD_BUDGET = 4 << 20;
+
+    explicit TextureLoader(size_t uploadBudget = DEFAULT_UPLOAD_BUDGET, ThreadPool &pool = ThreadPool::getShared());
+
+    // Waits for the decodes still running; textures that were never uploaded keep the placeholder
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader &) = delete;
+
+    TextureLoader &operator=(const TextureLoader &) = delete;
+
+    // channels 0 keeps the file's channel count, 3 and 4 force RGB and RGBA
+    unsigned int load(const std::string &filePath, int channels = 0);
+
+    // Uploads decoded images in the order their decodes finished, so a slow file does not hold back the ones
+    // requested after it, while they fit in the budget. Always uploads at least one, so an image larger than
+    // the budget still gets its own frame. Returns how many were uploaded.
+    int update();
+
+    // Blocks until every requested texture is uploaded, regardless of the budget
+    void finish();
+
+    bool isReady(unsigned int texture) const;
+
+    // Requested and not uploaded yet, whether still decoding or waiting for budget
+    int getPendingCount() const;
+
+    // Bytes of decoded level 0 data per update(); mipmap generation comes on top
+    void setUploadBudget(size_t bytes);
+
+private:
+    struct DecodedImage {
+        unsigned int texture;
+        std::string filePath;
+        // data is null when decoding failed
+        ImageInfo image;
+    };
+
+    ThreadPool &pool;
+    size_t uploadBudget;
+    MpscQueue<DecodedImage> decoded;
+    // Taken off the queue but left over from an earlier frame's budget
+    std::deque<DecodedImage> waiting;
+    std::vector<std::future<void>> decodes;
+    std::unordered_set<unsigned int> pending;
+
+    void collectDecoded();
+
+    void upload(DecodedImage &decodedImage);
+
+    static void uploadPlaceholder(unsigned int texture);
+
+    static size_t getSize(const ImageInfo &image);
+};
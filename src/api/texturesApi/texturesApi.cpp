@@ -3,56 +3,130 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include "texturesApi.h"
+#include "glStateApi.h"
 #include "stb_image.h"
+#include <cstring>
 #include <string>
+#include <vector>
 #include <iostream>
 
 using namespace std;
 
-unsigned int bindTextureRGB(const string &filePath) {
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+unsigned int getImageFormat(int channels) {
+    switch (channels) {
+        case 1:
+            return GL_RED;
+        case 2:
+            return GL_RG;
+        case 3:
+            return GL_RGB;
+        default:
+            return GL_RGBA;
+    }
+}
 
-    int width;
-    int height;
-    int nrChannels;
+// Reused for every flipped upload; glBufferData orphans the previous contents
+unsigned int getUploadBuffer() {
+    static unsigned int uploadBuffer = 0;
+    if (uploadBuffer == 0) {
+        glGenBuffers(1, &uploadBuffer);
+    }
+    return uploadBuffer;
+}
 
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+ImageInfo decodeImage(const string &filePath, int channels, bool flipVertically) {
+    ImageInfo image{0, 0, 0, nullptr};
+    stbi_set_flip_vertically_on_load_thread(flipVertically);
+    image.data = stbi_load(filePath.c_str(), &image.width, &image.height, &image.nrChannels, channels);
+    if (channels != 0) {
+        image.nrChannels = channels;
+    }
+    return image;
+}
 
-    if (data) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    } else {
-        cout << "Failed to load texture! Path: " << filePath << endl;
+ImageInfo decodeImage(const unsigned char *content, size_t size, int channels, bool flipVertically) {
+    ImageInfo image{0, 0, 0, nullptr};
+    stbi_set_flip_vertically_on_load_thread(flipVertically);
+    image.data = stbi_load_from_memory(content, static_cast<int>(size), &image.width, &image.height,
+                                       &image.nrChannels, channels);
+    if (channels != 0) {
+        image.nrChannels = channels;
     }
+    return image;
+}
 
-    stbi_image_free(data);
+void freeImage(ImageInfo &image) {
+    stbi_image_free(image.data);
+    image.data = nullptr;
+}
 
-    return texture;
+void uploadImage(const ImageInfo &image, bool flipVertically) {
+    unsigned int format = getImageFormat(image.nrChannels);
+    size_t rowSize = static_cast<size_t>(image.width) * image.nrChannels;
+    size_t size = rowSize * image.height;
+    const void *pixels = image.data;
+    vector<unsigned char> flippedPixels;
+    bool usesUploadBuffer = false;
+
+    if (flipVertically) {
+        GlState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, getUploadBuffer());
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<long> (size), nullptr, GL_STREAM_DRAW);
+        auto *rows = static_cast<unsigned char *>(glMapBufferRange(
+                GL_PIXEL_UNPACK_BUFFER, 0, static_cast<long> (size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        usesUploadBuffer = rows != nullptr;
+        if (!usesUploadBuffer) {
+            // The map can fail, e.g. when the driver is out of memory, so the rows are flipped on the CPU instead
+            GlState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            flippedPixels.resize(size);
+            rows = flippedPixels.data();
+        }
+        for (int row = 0; row < image.height; row++) {
+            memcpy(rows + (image.height - 1 - row) * rowSize, image.data + row * rowSize, rowSize);
+        }
+        if (usesUploadBuffer) {
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            // With an unpack buffer bound the pointer is an offset into it
+            pixels = nullptr;
+        } else {
+            pixels = flippedPixels.data();
+        }
+    }
+
+    // Rows of RGB images are generally not 4-byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, static_cast<int>(format), image.width, image.height, 0, format,
+                 GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    if (usesUploadBuffer) {
+        GlState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
 }
 
-unsigned int bindTextureRGBA(const string &filePath) {
+unsigned int loadTexture(const string &filePath, int channels) {
     unsigned int texture;
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-
-    int width;
-    int height;
-    int nrChannels;
+    GlState::activeTexture(0);
+    GlState::bindTexture(0, GL_TEXTURE_2D, texture);
 
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+    ImageInfo image = decodeImage(filePath, channels);
 
-    if (data) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    if (image.data) {
+        uploadImage(image, true);
     } else {
         cout << "Failed to load texture! Path: " << filePath << endl;
     }
 
-    stbi_image_free(data);
+    freeImage(image);
 
     return texture;
 }
+
+unsigned int bindTextureRGB(const string &filePath) {
+    return loadTexture(filePath, 3);
+}
+
+unsigned int bindTextureRGBA(const string &filePath) {
+    return loadTexture(filePath, 4);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <string>
 
 struct ImageInfo {
@@ -11,3 +12,16 @@ struct ImageInfo {
 unsigned int bindTextureRGB(const std::string &filePath);
 
 unsigned int bindTextureRGBA(const std::string &filePath);
+
+// Safe to call from several threads at once: the flip flag is stb_image's thread-local one, not the global that
+// stbi_set_flip_vertically_on_load sets. channels 0 keeps the file's channel count. data is null on failure.
+ImageInfo decodeImage(const std::string &filePath, int channels = 0, bool flipVertically = false);
+
+// Same for an encoded file already in memory
+ImageInfo decodeImage(const unsigned char *content, size_t size, int channels = 0, bool flipVertically = false);
+
+void freeImage(ImageInfo &image);
+
+// Uploads level 0 of the texture bound to GL_TEXTURE_2D and generates its mipmaps. With flipVertically the rows
+// are written bottom-up into a pixel unpack buffer, so the flip costs no pass of its own over the image.
+void uploadImage(const ImageInfo &image, bool flipVertically);
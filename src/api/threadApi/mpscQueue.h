@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// Lock-free queue for any number of producer threads and a single consumer. Producers push onto a linked stack
+// with one compare-and-swap; the consumer detaches the whole stack with one exchange and reverses it. Since
+// nodes are never popped one at a time, a node cannot be freed and reused under a producer's CAS (no ABA).
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() = default;
+
+    ~MpscQueue() {
+        popAll();
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    void push(T value) {
+        Node *node = new Node{std::move(value), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    // Everything pushed so far, oldest first. Only the consumer thread may call this.
+    std::vector<T> popAll() {
+        Node *node = head.exchange(nullptr, std::memory_order_acquire);
+        std::vector<T> values;
+        while (node) {
+            values.push_back(std::move(node->value));
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+        std::reverse(values.begin(), values.end());
+        return values;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        T value;
+        Node *next;
+    };
+
+    std::atomic<Node *> head{nullptr};
+};
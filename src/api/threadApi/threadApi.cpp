@@ -0,0 +1,97 @@
+#include "threadApi.h"
+#include <algorithm>
+
+using namespace std;
+
+ThreadPool::ThreadPool(unsigned int threadCount) : stopping(false) {
+    if (threadCount == 0) {
+        threadCount = max(thread::hardware_concurrency(), 2u) - 1;
+    }
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(tasksMutex);
+        stopping = true;
+    }
+    tasksAvailable.notify_all();
+    for (thread &worker: workers) {
+        worker.join();
+    }
+}
+
+// Tasks already queued are still run before the workers exit
+void ThreadPool::workerLoop() {
+    while (true) {
+        packaged_task<void()> task;
+        {
+            unique_lock<mutex> lock(tasksMutex);
+            tasksAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+future<void> ThreadPool::submit(function<void()> task) {
+    packaged_task<void()> packagedTask(std::move(task));
+    future<void> result = packagedTask.get_future();
+    {
+        lock_guard<mutex> lock(tasksMutex);
+        tasks.push(std::move(packagedTask));
+    }
+    tasksAvailable.notify_one();
+    return result;
+}
+
+void ThreadPool::parallelFor(int count, const function<void(int begin, int end)> &body) {
+    if (count <= 0) {
+        return;
+    }
+
+    int rangeCount = min(count, static_cast<int>(workers.size()) + 1);
+    auto getRangeStart = [count, rangeCount](int range) {
+        return static_cast<int>(static_cast<long long>(count) * range / rangeCount);
+    };
+
+    vector<future<void>> results;
+    for (int range = 1; range < rangeCount; range++) {
+        int begin = getRangeStart(range);
+        int end = getRangeStart(range + 1);
+        results.push_back(submit([&body, begin, end] { body(begin, end); }));
+    }
+
+    // Every range is waited for before rethrowing, since they all reference body
+    exception_ptr error;
+    try {
+        body(0, getRangeStart(1));
+    } catch (...) {
+        error = current_exception();
+    }
+    for (future<void> &result: results) {
+        try {
+            result.get();
+        } catch (...) {
+            error = current_exception();
+        }
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+unsigned int ThreadPool::getThreadCount() const {
+    return static_cast<unsigned int>(workers.size());
+}
+
+ThreadPool &ThreadPool::getShared() {
+    static ThreadPool pool;
+    return pool;
+}
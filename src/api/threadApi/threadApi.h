@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads taking tasks from one queue. Exceptions thrown by a task are kept in its future.
+class ThreadPool {
+public:
+    // Zero means one thread per hardware thread except the one the pool is created from, which usually
+    // has work of its own (and takes a share of every parallelFor)
+    explicit ThreadPool(unsigned int threadCount = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    std::future<void> submit(std::function<void()> task);
+
+    // Splits [0, count) into one contiguous range per thread and returns when all of them are done. The calling
+    // thread runs the first range itself, so this also makes progress on a pool with a single worker.
+    void parallelFor(int count, const std::function<void(int begin, int end)> &body);
+
+    unsigned int getThreadCount() const;
+
+    // Created on first use and shared by everything that does not need a pool of its own
+    static ThreadPool &getShared();
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::packaged_task<void()>> tasks;
+    std::mutex tasksMutex;
+    std::condition_variable tasksAvailable;
+    bool stopping;
+
+    void workerLoop();
+};
@@ -3,7 +3,12 @@
 out vec4 fragmentColor;
 
 uniform vec3 objectColor;
-uniform vec3 lightColor;
+
+layout (std140) uniform Light
+{
+    vec3 lightPos;
+    vec3 lightColor;
+};
 
 void main() {
     fragmentColor = vec4(lightColor * objectColor, 1.0);
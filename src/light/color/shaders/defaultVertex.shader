@@ -3,8 +3,13 @@
 layout(location = 0) in vec3 aPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+layout (std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 
 void main(){
     gl_Position = projection * view * model * vec4(aPos, 1.0);
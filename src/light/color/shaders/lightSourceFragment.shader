@@ -1,7 +1,11 @@
 #version 330 core
 out vec4 FragColor;
 
-uniform vec3 lightColor;
+layout (std140) uniform Light
+{
+    vec3 lightPos;
+    vec3 lightColor;
+};
 
 void main()
 {
@@ -1,6 +1,10 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
+#include "profilerApi.h"
+#include "shaderPreprocessor.h"
 #include "cameraApi.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -27,36 +31,22 @@ bool firstMouse = true;
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
-int main()
-{
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+int main(int argc, char *argv[]) {
+    // window, or a headless context when asked for on the command line
+    // ----------------------------------------------------------------
+    RenderContext context(argc, argv, SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", true);
+    if (!context.isCreated()) {
         return -1;
     }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
 
-    // tell GLFW to capture our mouse
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (glewInit() != GLEW_OK) {
-        return -1;
+        // tell GLFW to capture our mouse
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
 
     // configure global opengl state
@@ -65,7 +55,8 @@ int main()
 
     // build and compile our shader zprogram
     // ------------------------------------
-    ShaderProgram lightingShader = ShaderProgram::createShaderProgramFromFiles("/home/mlgmag/CLionProjects/graphicsLabs/src/light/phongLightning/full/shaders/2.2.basic_lighting.vs", "/home/mlgmag/CLionProjects/graphicsLabs/src/light/phongLightning/full/shaders/2.2.basic_lighting.fs");
+    ShaderPermutationCache shaderCache;
+    ShaderProgram &lightingShader = shaderCache.get("/home/mlgmag/CLionProjects/graphicsLabs/src/light/shaders/phong.vs", "/home/mlgmag/CLionProjects/graphicsLabs/src/light/shaders/phong.fs", {{"DIFFUSE", ""}, {"SPECULAR", ""}, {"USE_UNIFORM_BLOCKS", ""}});
     ShaderProgram lightCubeShader = ShaderProgram::createShaderProgramFromFiles("/home/mlgmag/CLionProjects/graphicsLabs/src/light/phongLightning/full/shaders/2.2.light_cube.vs", "/home/mlgmag/CLionProjects/graphicsLabs/src/light/phongLightning/full/shaders/2.2.light_cube.fs");
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
@@ -118,10 +109,10 @@ int main()
     glGenVertexArrays(1, &cubeVAO);
     glGenBuffers(1, &VBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(cubeVAO);
+    GlState::bindVertexArray(cubeVAO);
 
     // position attribute
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
@@ -134,27 +125,33 @@ int main()
     // second, configure the light's VAO (VBO stays the same; the vertices are the same for the light object which is also a 3D cube)
     unsigned int lightCubeVAO;
     glGenVertexArrays(1, &lightCubeVAO);
-    glBindVertexArray(lightCubeVAO);
+    GlState::bindVertexArray(lightCubeVAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, VBO);
     // note that we update the lamp's position attribute's stride to reflect the updated buffer data
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
 
+    // camera and light data shared by both programs through uniform buffers
+    UniformBuffer cameraBuffer = UniformBuffer::create("Camera", sizeof(CameraBlock));
+    UniformBuffer lightBuffer = UniformBuffer::create("Light", sizeof(LightBlock));
+
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    while (!context.shouldClose())
     {
         // per-frame time logic
         // --------------------
-        float currentFrame = glfwGetTime();
+        float currentFrame = context.getTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
         // input
         // -----
-        processInput(window);
+        if (window) {
+            processInput(window);
+        }
 
         // render
         // ------
@@ -167,45 +164,43 @@ int main()
 
         // lighting
         auto lightModel = glm::mat4(1.0f);
-        lightModel = glm::rotate(lightModel, (float) glfwGetTime() * glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        lightModel = glm::rotate(lightModel, (float) context.getTime() * glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
         lightModel = glm::translate(lightModel, glm::vec3(0.0f, 0.0f, -3.0f));
         lightModel = glm::scale(lightModel, glm::vec3(0.2f));
 
         glm::vec4 lightPos4 = lightModel * glm::vec4 (1.0f, 1.0f, 1.0f, 1.0f);
         auto lightPos = glm::vec3(lightPos4.x, lightPos4.y, lightPos4.z);
 
+        cameraBuffer.update(CameraBlock{projection, view, camera.Position});
+        lightBuffer.update(LightBlock{lightPos, glm::vec3(1.0f, 1.0f, 1.0f)});
+
         // also draw the lamp object
+        Profiler::beginScope("light cube");
         lightCubeShader.use();
-        lightCubeShader.setMat4("projection", projection);
-        lightCubeShader.setMat4("view", view);
-        lightCubeShader.setMat4("model", lightModel);
+        lightCubeShader.setMat4("model"_u, lightModel);
 
-        glBindVertexArray(lightCubeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        GlState::bindVertexArray(lightCubeVAO);
+        GlState::drawArrays(GL_TRIANGLES, 0, 36);
+        Profiler::endScope();
 
         // be sure to activate shader when setting uniforms/drawing objects
+        Profiler::beginScope("cube");
         lightingShader.use();
-        lightingShader.setVec3("objectColor", 1.0f, 0.5f, 0.31f);
-        lightingShader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
-        lightingShader.setVec3("lightPos", lightPos);
-        lightingShader.setVec3("viewPos", camera.Position);
-
-        lightingShader.setMat4("projection", projection);
-        lightingShader.setMat4("view", view);
+        lightingShader.setVec3("objectColor"_u, 1.0f, 0.5f, 0.31f);
 
         // world transformation
         auto model = glm::mat4(1.0f);
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(45.0f), glm::vec3(1.0f, 1.0f, 0.0f));
-        lightingShader.setMat4("model", model);
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(45.0f), glm::vec3(1.0f, 1.0f, 0.0f));
+        lightingShader.setMat4("model"_u, model);
 
         // render the cube
-        glBindVertexArray(cubeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        GlState::bindVertexArray(cubeVAO);
+        GlState::drawArrays(GL_TRIANGLES, 0, 36);
+        Profiler::endScope();
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
         // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     // optional: de-allocate all resources once they've outlived their purpose:
@@ -214,9 +209,6 @@ int main()
     glDeleteVertexArrays(1, &lightCubeVAO);
     glDeleteBuffers(1, &VBO);
 
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
 }
 
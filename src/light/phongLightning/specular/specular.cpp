@@ -1,7 +1,12 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
+#include "profilerApi.h"
+#include "shaderPreprocessor.h"
 #include "cameraApi.h"
+#include "vertexFormat.h"
 #include <vector>
 #include <string>
 #include <glm/glm.hpp>
@@ -10,10 +15,6 @@
 
 using namespace std;
 
-struct GraphicContext {
-    GLFWwindow *window;
-};
-
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
@@ -42,16 +43,6 @@ void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 
-GLFWwindow *createWindow(const GLint &width, const GLint &height, const string &title) {
-    GLFWwindow *window;
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        exit(-1);
-    }
-    return window;
-}
-
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
 }
@@ -70,8 +61,8 @@ void processInput(GLFWwindow *window) {
         camera.ProcessKeyboard(RIGHT, deltaTime);
 }
 
-void calculateFrames() {
-    auto currentFrame = static_cast<float>(glfwGetTime());
+void calculateFrames(const RenderContext &context) {
+    auto currentFrame = static_cast<float>(context.getTime());
     deltaTime = currentFrame - lastFrame;
     lastFrame = currentFrame;
 }
@@ -85,21 +76,17 @@ unsigned int generateCubeVertexArray() {
     glGenVertexArrays(1, &vertexArray);
     glGenBuffers(1, &vertexBuffer);
 
-    glBindVertexArray(vertexArray);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    unsigned long vertexBufferSize = positions.size() * sizeof(float);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
+    GlState::bindVertexArray(vertexArray);
 
-    int strideSize = 6 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strideSize, nullptr);
-    glEnableVertexAttribArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    VertexFormat format = VertexFormat::compactPositionNormal();
+    vector<unsigned char> vertices = format.pack(positions);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertices.size()), vertices.data(), GL_STATIC_DRAW);
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    format.setAttributePointers();
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
@@ -116,110 +103,102 @@ unsigned int generatePlateVertexArray() {
     glGenBuffers(1, &vertexBuffer);
     glGenBuffers(1, &elementBuffer);
 
-    glBindVertexArray(vertexArray);
+    GlState::bindVertexArray(vertexArray);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    unsigned long vertexBufferSize = positions.size() * sizeof(float);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertexBufferSize), &positions.front(), GL_STATIC_DRAW);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    VertexFormat format = VertexFormat::compactPositionNormal();
+    vector<unsigned char> vertices = format.pack(positions);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (vertices.size()), vertices.data(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
     unsigned long elementBufferSize = indices.size() * sizeof(unsigned int);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long> (elementBufferSize), &indices.front(), GL_STATIC_DRAW);
 
-    int strideSize = 6 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strideSize, nullptr);
-    glEnableVertexAttribArray(0);
+    format.setAttributePointers();
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strideSize, (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GlState::bindVertexArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GlState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     return vertexArray;
 }
 
-void graphicLogic(const GraphicContext &context) {
-    ShaderProgram lightSourceShaderProgram = ShaderProgram::createShaderProgramFromFiles(getDefaultVertexShaderPath(),
-                                                                                         getLightSourceFragmentShaderPath());
-    ShaderProgram defaultShaderProgram = ShaderProgram::createShaderProgramFromFiles(getDefaultVertexShaderPath(),
-                                                                                     getDefaultFragmentShaderPath());
+void graphicLogic(RenderContext &context) {
+    ShaderPermutationCache shaderCache;
+    ShaderProgram &lightSourceShaderProgram = shaderCache.get(getDefaultVertexShaderPath(),
+                                                              getLightSourceFragmentShaderPath(),
+                                                              {{"USE_UNIFORM_BLOCKS", ""}});
+    ShaderProgram &defaultShaderProgram = shaderCache.get(getDefaultVertexShaderPath(), getDefaultFragmentShaderPath(),
+                                                          {{"DIFFUSE", ""}, {"SPECULAR", ""}, {"SPECULAR_EXPONENT", "128"},
+                                                           {"USE_UNIFORM_BLOCKS", ""}});
 
     unsigned int cubeVertexArray = generateCubeVertexArray();
     unsigned int plateVertexArray = generatePlateVertexArray();
 
+    // camera and light data shared by both programs through uniform buffers
+    UniformBuffer cameraBuffer = UniformBuffer::create("Camera", sizeof(CameraBlock));
+    UniformBuffer lightBuffer = UniformBuffer::create("Light", sizeof(LightBlock));
+
     glm::vec3 objColor(1.0f, 0.5f, 0.31f);
     glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
 
-    while (!glfwWindowShouldClose(context.window)) {
-        calculateFrames();
-        processInput(context.window);
+    while (!context.shouldClose()) {
+        calculateFrames(context);
+        if (context.getWindow()) {
+            processInput(context.getWindow());
+        }
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Drawing plate
-        defaultShaderProgram.use();
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float) WIDTH / (float) HEIGHT, 0.1f,
                                                 100.0f);
-        defaultShaderProgram.setMat4("projection", projection);
-
-        glm::mat4 view = camera.GetViewMatrix();
-        defaultShaderProgram.setMat4("view", view);
+        cameraBuffer.update(CameraBlock{projection, camera.GetViewMatrix(), camera.Position});
+        lightBuffer.update(LightBlock{glm::vec3(0.0f, 0.0f, 0.0f), lightColor});
 
+        // Drawing plate
+        Profiler::beginScope("plate");
+        defaultShaderProgram.use();
         auto model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(0.0f, -5.0f, 0.0f));
-        defaultShaderProgram.setMat4("model", model);
+        defaultShaderProgram.setMat4("model"_u, model);
 
-        defaultShaderProgram.setVec3("objectColor", objColor);
-        defaultShaderProgram.setVec3("lightColor", lightColor);
-        defaultShaderProgram.setVec3("lightPos", glm::vec3(0.0f, 0.0f, 0.0f));
-        defaultShaderProgram.setVec3("viewPos", camera.Position);
+        defaultShaderProgram.setVec3("objectColor"_u, objColor);
 
-        glBindVertexArray(plateVertexArray);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        GlState::bindVertexArray(plateVertexArray);
+        GlState::drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        Profiler::endScope();
 
         // Drawing of light cube
+        Profiler::beginScope("light cube");
         lightSourceShaderProgram.use();
-        projection = glm::perspective(glm::radians(camera.Zoom), (float) WIDTH / (float) HEIGHT, 0.1f, 100.0f);
-        defaultShaderProgram.setMat4("projection", projection);
-
-        view = camera.GetViewMatrix();
-        defaultShaderProgram.setMat4("view", view);
-
         model = glm::mat4(1.0f);
-        defaultShaderProgram.setMat4("model", model);
+        lightSourceShaderProgram.setMat4("model"_u, model);
 
-        lightSourceShaderProgram.setVec3("lightColor", lightColor);
+        GlState::bindVertexArray(cubeVertexArray);
+        GlState::drawArrays(GL_TRIANGLES, 0, 36);
+        Profiler::endScope();
 
-        glBindVertexArray(cubeVertexArray);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-
-        glfwSwapBuffers(context.window);
-        glfwPollEvents();
+        context.swapBuffers();
     }
 }
 
-int main() {
-    if (!glfwInit()) {
+int main(int argc, char *argv[]) {
+    RenderContext context(argc, argv, WIDTH, HEIGHT, getTitle());
+    if (!context.isCreated()) {
         return -1;
     }
 
-    GLFWwindow *window = createWindow(WIDTH, HEIGHT, getTitle());
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (glewInit() != GLEW_OK) {
-        return -1;
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
     glEnable(GL_DEPTH_TEST);
 
-    GraphicContext graphicContext{window};
-    graphicLogic(graphicContext);
+    graphicLogic(context);
 
-    glfwTerminate();
     return 0;
 }
 
@@ -312,11 +291,11 @@ void scroll_callback(GLFWwindow *window, double xoffset, double yoffset) {
 }
 
 string getDefaultVertexShaderPath() {
-    return "/home/mlgmag/CLionProjects/graphicsLabs/src/light/phongLightning/specular/shaders/defaultVertex.shader";
+    return "/home/mlgmag/CLionProjects/graphicsLabs/src/light/shaders/phong.vs";
 }
 
 string getDefaultFragmentShaderPath() {
-    return "/home/mlgmag/CLionProjects/graphicsLabs/src/light/phongLightning/specular/shaders/defaultFragment.shader";
+    return "/home/mlgmag/CLionProjects/graphicsLabs/src/light/shaders/phong.fs";
 
 }
 
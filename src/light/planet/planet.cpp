@@ -1,10 +1,18 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "contextApi.h"
 #include "shaderApi.h"
+#include "glStateApi.h"
+#include "profilerApi.h"
+#include "shaderPreprocessor.h"
+#include "shaderWatcher.h"
 #include "cameraApi.h"
+#include "vertexFormat.h"
+#include "parametricMesher.h"
 #include <glm/glm.hpp>
 
 #include <iostream>
+#include <vector>
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 
@@ -28,34 +36,29 @@ bool firstMouse = true;
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
-int main() {
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow *window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
-    if (window == NULL) {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+// shaders
+const char *LIGHTING_VERTEX_SHADER_PATH = "/home/mlgmag/CLionProjects/graphicsLabs/src/light/shaders/phong.vs";
+const char *LIGHTING_FRAGMENT_SHADER_PATH = "/home/mlgmag/CLionProjects/graphicsLabs/src/light/shaders/phong.fs";
+const ShaderDefines LIGHTING_DEFINES = {{"DIFFUSE", ""}, {"SPECULAR", ""}, {"USE_UNIFORM_BLOCKS", ""}};
+const char *LIGHT_CUBE_VERTEX_SHADER_PATH = "/home/mlgmag/CLionProjects/graphicsLabs/src/light/planet/shaders/2.2.light_cube.vs";
+const char *LIGHT_CUBE_FRAGMENT_SHADER_PATH = "/home/mlgmag/CLionProjects/graphicsLabs/src/light/planet/shaders/2.2.light_cube.fs";
+
+int main(int argc, char *argv[]) {
+    // window, or a headless context when asked for on the command line
+    // ----------------------------------------------------------------
+    RenderContext context(argc, argv, SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", true);
+    if (!context.isCreated()) {
         return -1;
     }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
 
-    // tell GLFW to capture our mouse
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    GLFWwindow *window = context.getWindow();
+    if (window) {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (glewInit() != GLEW_OK) {
-        return -1;
+        // tell GLFW to capture our mouse
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
 
     // configure global opengl state
@@ -64,12 +67,22 @@ int main() {
 
     // build and compile our shader zprogram
     // ------------------------------------
-    ShaderProgram lightingShader = ShaderProgram::createShaderProgramFromFiles(
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/light/planet/shaders/2.2.basic_lighting.vs",
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/light/planet/shaders/2.2.basic_lighting.fs");
-    ShaderProgram lightCubeShader = ShaderProgram::createShaderProgramFromFiles(
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/light/planet/shaders/2.2.light_cube.vs",
-            "/home/mlgmag/CLionProjects/graphicsLabs/src/light/planet/shaders/2.2.light_cube.fs");
+    // both programs are submitted before either is checked, so the driver can compile them in parallel
+    PendingShaderProgram pendingLightingShader = ShaderProgram::compileAsync(
+            ShaderPreprocessor::processFile(LIGHTING_VERTEX_SHADER_PATH, LIGHTING_DEFINES),
+            ShaderPreprocessor::processFile(LIGHTING_FRAGMENT_SHADER_PATH, LIGHTING_DEFINES));
+    PendingShaderProgram pendingLightCubeShader = ShaderProgram::compileAsyncFromFiles(LIGHT_CUBE_VERTEX_SHADER_PATH,
+                                                                                     LIGHT_CUBE_FRAGMENT_SHADER_PATH);
+    ShaderProgram lightingShader = pendingLightingShader.get();
+    ShaderProgram lightCubeShader = pendingLightCubeShader.get();
+    if (lightingShader.getShaderProgramId() == 0 || lightCubeShader.getShaderProgramId() == 0) {
+        return -1;
+    }
+
+    // edit the shader files while the scene is running to see the changes without a restart
+    ShaderWatcher shaderWatcher;
+    shaderWatcher.watch(lightingShader, LIGHTING_VERTEX_SHADER_PATH, LIGHTING_FRAGMENT_SHADER_PATH, LIGHTING_DEFINES);
+    shaderWatcher.watch(lightCubeShader, LIGHT_CUBE_VERTEX_SHADER_PATH, LIGHT_CUBE_FRAGMENT_SHADER_PATH);
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
@@ -116,47 +129,56 @@ int main() {
             -0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
             -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f
     };
+    // half-float positions and packed normals, 12 bytes per vertex instead of 24
+    VertexFormat cubeFormat = VertexFormat::compactPositionNormal();
+    size_t vertexCount = sizeof(vertices) / sizeof(float) / cubeFormat.getFloatsPerVertex();
+    std::vector<unsigned char> packedVertices = cubeFormat.pack(vertices, vertexCount);
+
     // first, configure the cube's VAO (and VBO)
     unsigned int VBO, cubeVAO;
     glGenVertexArrays(1, &cubeVAO);
     glGenBuffers(1, &VBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindVertexArray(cubeVAO);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long> (packedVertices.size()), packedVertices.data(), GL_STATIC_DRAW);
 
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *) 0);
-    glEnableVertexAttribArray(0);
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *) (3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    GlState::bindVertexArray(cubeVAO);
+    cubeFormat.setAttributePointers();
 
 
     // second, configure the light's VAO (VBO stays the same; the vertices are the same for the light object which is also a 3D cube)
     unsigned int lightCubeVAO;
     glGenVertexArrays(1, &lightCubeVAO);
-    glBindVertexArray(lightCubeVAO);
+    GlState::bindVertexArray(lightCubeVAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // note that we update the lamp's position attribute's stride to reflect the updated buffer data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *) 0);
-    glEnableVertexAttribArray(0);
+    GlState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    // the light's shader only reads the position, the normal attribute is ignored
+    cubeFormat.setAttributePointers();
 
+    // the green and blue planets are a sphere and a cylinder, with the normals in attribute 1 like the cube's
+    ParametricMeshBuffers sphereBuffers = ParametricMesher::upload(ParametricMesher::sphere(0.5f, 16, 32));
+    ParametricMeshBuffers cylinderBuffers = ParametricMesher::upload(ParametricMesher::cylinder(0.5f, 1.0f, 32));
+
+
+    // camera and light data shared by both programs through uniform buffers
+    UniformBuffer cameraBuffer = UniformBuffer::create("Camera", sizeof(CameraBlock));
+    UniformBuffer lightBuffer = UniformBuffer::create("Light", sizeof(LightBlock));
 
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window)) {
+    while (!context.shouldClose()) {
         // per-frame time logic
         // --------------------
-        float currentFrame = glfwGetTime();
+        float currentFrame = context.getTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
         // input
         // -----
-        processInput(window);
+        if (window) {
+            processInput(window);
+        }
+        shaderWatcher.update();
 
         // render
         // ------
@@ -175,64 +197,66 @@ int main() {
         glm::vec4 lightPos4 = lightModel * glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
         auto lightPos = glm::vec3(lightPos4.x, lightPos4.y, lightPos4.z);
 
+        cameraBuffer.update(CameraBlock{projection, view, camera.Position});
+        lightBuffer.update(LightBlock{lightPos, glm::vec3(1.0f, 1.0f, 1.0f)});
+
         // also draw the lamp object
+        Profiler::beginScope("light cube");
         lightCubeShader.use();
-        lightCubeShader.setMat4("projection", projection);
-        lightCubeShader.setMat4("view", view);
-        lightCubeShader.setMat4("model", lightModel);
+        lightCubeShader.setMat4("model"_u, lightModel);
 
-        glBindVertexArray(lightCubeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        GlState::bindVertexArray(lightCubeVAO);
+        GlState::drawArrays(GL_TRIANGLES, 0, 36);
+        Profiler::endScope();
 
         // be sure to activate shader when setting uniforms/drawing objects
         lightingShader.use();
-        lightingShader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
-        lightingShader.setVec3("lightPos", lightPos);
-        lightingShader.setVec3("viewPos", camera.Position);
-
-        lightingShader.setMat4("projection", projection);
-        lightingShader.setMat4("view", view);
 
         // Red cube
-        lightingShader.setVec3("objectColor", 1.0f, 0.0f, 0.0f);
+        Profiler::beginScope("red cube");
+        lightingShader.setVec3("objectColor"_u, 1.0f, 0.0f, 0.0f);
         auto model = glm::mat4(1.0f);
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(22.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(22.5f), glm::vec3(0.0f, 1.0f, 0.0f));
         model = glm::translate(model, glm::vec3(3.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(22.5f), glm::vec3(1.0f, 0.0f, 1.0f));
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(22.5f), glm::vec3(1.0f, 0.0f, 1.0f));
         model = glm::scale(model, glm::vec3(0.8f));
-        lightingShader.setMat4("model", model);
+        lightingShader.setMat4("model"_u, model);
 
-        glBindVertexArray(cubeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        GlState::bindVertexArray(cubeVAO);
+        GlState::drawArrays(GL_TRIANGLES, 0, 36);
+        Profiler::endScope();
 
-        // Cube green
-        lightingShader.setVec3("objectColor", 0.0f, 1.0f, 0.0f);
+        // Sphere green
+        Profiler::beginScope("green sphere");
+        lightingShader.setVec3("objectColor"_u, 0.0f, 1.0f, 0.0f);
         model = glm::mat4(1.0f);
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(22.5f), glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(22.5f), glm::vec3(1.0f, 0.0f, 0.0f));
         model = glm::translate(model, glm::vec3(0.0f, 3.0f, 0.0f));
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(22.5f), glm::vec3(0.0f, 1.0f, 1.0f));
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(22.5f), glm::vec3(0.0f, 1.0f, 1.0f));
         model = glm::scale(model, glm::vec3(0.8f));
-        lightingShader.setMat4("model", model);
+        lightingShader.setMat4("model"_u, model);
 
-        glBindVertexArray(cubeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        ParametricMesher::draw(sphereBuffers);
+        Profiler::endScope();
 
-        // Cube blue
-        lightingShader.setVec3("objectColor", 0.0f, 0.0f, 1.0f);
+        // Cylinder blue
+        Profiler::beginScope("blue cylinder");
+        lightingShader.setVec3("objectColor"_u, 0.0f, 0.0f, 1.0f);
         model = glm::mat4(1.0f);
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(22.5f), glm::vec3(1.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(22.5f), glm::vec3(1.0f, 1.0f, 0.0f));
         model = glm::translate(model, glm::vec3(0.0f, 0.0f, 3.0f));
-        model = glm::rotate(model, (float) glfwGetTime() * glm::radians(22.5f), glm::vec3(1.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, (float) context.getTime() * glm::radians(22.5f), glm::vec3(1.0f, 1.0f, 0.0f));
         model = glm::scale(model, glm::vec3(0.8f));
-        lightingShader.setMat4("model", model);
+        // the cylinder stands on y = 0, so it is moved down to spin around its middle
+        model = glm::translate(model, glm::vec3(0.0f, -0.5f, 0.0f));
+        lightingShader.setMat4("model"_u, model);
 
-        glBindVertexArray(cubeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        ParametricMesher::draw(cylinderBuffers);
+        Profiler::endScope();
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
         // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        context.swapBuffers();
     }
 
     // optional: de-allocate all resources once they've outlived their purpose:
@@ -240,10 +264,12 @@ int main() {
     glDeleteVertexArrays(1, &cubeVAO);
     glDeleteVertexArrays(1, &lightCubeVAO);
     glDeleteBuffers(1, &VBO);
+    for (const ParametricMeshBuffers &buffers: {sphereBuffers, cylinderBuffers}) {
+        glDeleteVertexArrays(1, &buffers.vertexArray);
+        glDeleteBuffers(1, &buffers.vertexBuffer);
+        glDeleteBuffers(1, &buffers.elementBuffer);
+    }
 
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
 }
 
@@ -0,0 +1,43 @@
+#version 330 core
+
+// Variants: DIFFUSE, SPECULAR, USE_UNIFORM_BLOCKS flags, AMBIENT_STRENGTH and SPECULAR_EXPONENT values
+#ifndef AMBIENT_STRENGTH
+#define AMBIENT_STRENGTH 0.1
+#endif
+
+#ifndef SPECULAR_EXPONENT
+#define SPECULAR_EXPONENT 32
+#endif
+
+#include "phongUniforms.glsl"
+
+in vec3 Normal;
+in vec3 FragPos;
+
+out vec4 FragColor;
+
+uniform vec3 objectColor;
+
+void main() {
+    vec3 result = AMBIENT_STRENGTH * lightColor;
+
+#if defined(DIFFUSE) || defined(SPECULAR)
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+#endif
+
+#ifdef DIFFUSE
+    float diff = max(dot(norm, lightDir), 0.0);
+    result += diff * lightColor;
+#endif
+
+#ifdef SPECULAR
+    float specularStrength = 0.5;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), SPECULAR_EXPONENT);
+    result += specularStrength * spec * lightColor;
+#endif
+
+    FragColor = vec4(result * objectColor, 1.0);
+}
@@ -1,18 +1,17 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
 
-out vec3 FragPos;
+#include "phongUniforms.glsl"
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+
 out vec3 Normal;
+out vec3 FragPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
-void main()
-{
+void main(){
     FragPos = vec3(model * vec4(aPos, 1.0));
     Normal = mat3(transpose(inverse(model))) * aNormal;
-
     gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
@@ -0,0 +1,22 @@
+// Camera and light inputs shared by every Phong variant
+#ifdef USE_UNIFORM_BLOCKS
+layout (std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
+
+layout (std140) uniform Light
+{
+    vec3 lightPos;
+    vec3 lightColor;
+};
+#else
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec3 viewPos;
+
+uniform vec3 lightPos;
+uniform vec3 lightColor;
+#endif